@@ -4,9 +4,12 @@ grammar YALLL;
 // General:
 program: (interface | class | declaration | definition)* entry_point? (interface | class | declaration | definition)* EOF;
 
+// a single item of a program, --stream parses them one at a time
+top_level: interface | class | declaration | definition | entry_point;
+
 interface: INTERFACE_KW NAME interface_block;
 
-class: CLASS_KW NAME (size)? (COLON_SYM NAME)? class_block;
+class: CLASS_KW name=NAME mem_size=size? (COLON_SYM interface_name=NAME)? body=class_block;
 
 entry_point: FUNCTION_KW LPAREN_SYM RPAREN_SYM COLON_SYM I32_T block;
 
@@ -45,9 +48,9 @@ definition:
   | var_def
   | lazy_var_def;
 
-function_def: FUNCTION_KW NOERR_KW? func_name=NAME parm_list=parameter_list COLON_SYM ret_type=type func_block=block;
+function_def: annotations+=annotation* FUNCTION_KW NOERR_KW? func_name=NAME parm_list=parameter_list COLON_SYM ret_type=type func_block=block;
 
-error_def: LBRACK_SYM NAME COMMA_SYM STRING RBRACK_SYM;
+error_def: LBRACK_SYM name=NAME COMMA_SYM message=STRING RBRACK_SYM;
 
 var_def: ty=type name=NAME EQUAL_SYM val=operation;
 
@@ -62,23 +65,35 @@ block: LCURL_SYM statements+=statement* RCURL_SYM;
 
 interface_block: LCURL_SYM function_dec* RCURL_SYM;
 
-class_block: ((PUBLIC_KW pp_block) | (PRIVATE_KW pp_block) | (ERROR_KW error_block))*;
+class_block: LCURL_SYM ((PUBLIC_KW pp_block) | (PRIVATE_KW pp_block) | (ERROR_KW error_block))* RCURL_SYM;
 
 pp_block: LCURL_SYM (function_def | declaration)* RCURL_SYM;
 
-error_block: LCURL_SYM error_def* RCURL_SYM;
+error_block: LCURL_SYM (errors+=error_def COMMA_SYM?)* RCURL_SYM;
 
 onerr_block: LCURL_SYM switch RCURL_SYM;
 
 // Control structures:
 control_structure:
     loop
-  | switch
-  | if_else;
+  | switch_stmt
+  | if_else
+  | annotated_block;
+
+
+  // @fastmath { ... }
+  annotated_block: annotations+=annotation+ body=block;
 
 
   // Switch
-  switch: (NAME COLON_SYM statement*)* DEFAULT_KW COLON_SYM statement*;
+  switch_stmt: SWITCH_KW LPAREN_SYM subject=operation RPAREN_SYM LCURL_SYM body=switch RCURL_SYM;
+
+  switch: cases+=switch_case* (DEFAULT_KW COLON_SYM default_body+=statement*)?;
+
+  // a case without statements shares the statements of the next case
+  switch_case: label=switch_label COLON_SYM statements+=statement*;
+
+  switch_label: NAME | MINSU_SYM? INTEGER;
 
   // Loops:
   loop:
@@ -88,7 +103,8 @@ control_structure:
 
   while_loop: LOOP_KW LPAREN_SYM cmp=operation RPAREN_SYM body=loop_body;
 
-  for_loop: LOOP_KW LPAREN_SYM (definition | assignment)? SEMICOLON_SYM operation? SEMICOLON_SYM operation? RPAREN_SYM loop_body;
+  // loop (i32! i = 0; i < n; i = i + 1) { ... }
+  for_loop: LOOP_KW LPAREN_SYM (init_def=definition | init_assign=assignment)? SEMICOLON_SYM cmp=operation? SEMICOLON_SYM (step_assign=assignment | step_op=operation)? RPAREN_SYM body=loop_body;
 
   foreach_loop: LOOP_KW LPAREN_SYM dec=declaration COLON_SYM iter=operation RPAREN_SYM body=loop_body;
 
@@ -98,9 +114,11 @@ control_structure:
   // If_else:
   if_else: if_br=if else_if_brs+=else_if* else_br=else?;
 
-  if: IF_KW LPAREN_SYM cmp=operation RPAREN_SYM body=block;
+  if: IF_KW hint=branch_hint? LPAREN_SYM cmp=operation RPAREN_SYM body=block;
 
-  else_if: ELSE_KW LPAREN_SYM cmp=operation RPAREN_SYM body=block;
+  else_if: ELSE_KW hint=branch_hint? LPAREN_SYM cmp=operation RPAREN_SYM body=block;
+
+  branch_hint: LIKELY_KW | UNLIKELY_KW;
 
   else: ELSE_KW body=block;
 
@@ -129,6 +147,7 @@ unary_op: op=(NOT_SYM | MINSU_SYM)? val=primary_op;
 primary_op:
     (LPAREN_SYM val=operation RPAREN_SYM) #primary_op_high_precedence
   | val=function_call #primary_op_fc
+  | NEW_KW name=NAME LPAREN_SYM args=argument_list RPAREN_SYM #primary_op_new
   | val=terminal_op #primary_op_term
   ;
 
@@ -145,13 +164,16 @@ terminal_op:
 
 
 // Misc:
-size: LBRACK_SYM INTEGER RBRACK_SYM;
+size: LBRACK_SYM val=INTEGER unit=NAME? RBRACK_SYM;
+
+// @name or @name(arg, ...)
+annotation: AT_SYM name=NAME (LPAREN_SYM (args+=(NAME | STRING) (COMMA_SYM args+=(NAME | STRING))*)? RPAREN_SYM)?;
 
 BOOL_TRUE: 'true';
 BOOL_FALSE: 'false';
 NULL_VALUE: 'null';
 
-function_call: name=NAME LPAREN_SYM args=argument_list RPAREN_SYM;
+function_call: annotations+=annotation* (scope=NAME SCOPE_SYM)? name=NAME LPAREN_SYM args=argument_list RPAREN_SYM;
 
 argument_list: (first_arg=operation (COMMA_SYM nth_arg+=operation)*)?;
 
@@ -169,7 +191,10 @@ ERRABLE_KW: 'err';
 MUTABLE_KW: 'mut';
 LOOP_KW: 'loop';
 IF_KW: 'if';
+SWITCH_KW: 'switch';
 ELSE_KW: 'else';
+LIKELY_KW: 'likely';
+UNLIKELY_KW: 'unlikely';
 NEW_KW: 'new';
 DEFAULT_KW: 'default';
 BREAK_KW: 'break';
@@ -207,8 +232,11 @@ type:
     | D32_T
     | STR_T
     | BOOL_T
+    | ERROR_KW
     | VOID_T
-    | TBD_T;
+    | TBD_T
+    | vec_t=VEC_T
+    | class_t=NAME;
 
 ISYS_T: 'isys';
 I64_T: 'i64';
@@ -226,6 +254,8 @@ STR_T: 'str';
 BOOL_T: 'bool';
 VOID_T: 'void';
 TBD_T: 'tbd';
+// i32x4, d32x8, boolx4, ...
+VEC_T: (('i' | 'u') ('8' | '16' | '32' | '64') | 'd' ('32' | '64') | 'bool') 'x' [0-9]+;
 
 
 // Regex types:
@@ -236,6 +266,7 @@ STRING: '"' ( ~["])* '"';
 
 
 // Symbols:
+SCOPE_SYM: '::';
 COLON_SYM: ':';
 SEMICOLON_SYM: ';';
 LPAREN_SYM: '(';
@@ -256,6 +287,7 @@ COMMA_SYM: ',';
 DOT_SYM: '.';
 QUESETIONMARK_SYM: '?';
 EQUAL_SYM: '=';
+AT_SYM: '@';
 
 compare_sym:
     GREATER_SYM
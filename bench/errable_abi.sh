@@ -0,0 +1,31 @@
+#!/usr/bin/env bash
+# Compiles programs/bench_errable_calls.y with both errable ABIs and times the
+# resulting binaries.
+#
+# usage: bench/errable_abi.sh [path to YALLL binary] [runs]
+set -euo pipefail
+
+root="$(cd "$(dirname "$0")/.." && pwd)"
+yallc="${1:-$root/build/YALLL}"
+runs="${2:-20}"
+program="$root/programs/bench_errable_calls.y"
+out="$(mktemp -d)"
+trap 'rm -rf "$out"' EXIT
+
+for abi in retptr registers; do
+  "$yallc" -f "$program" -o "$out/$abi.ll" --errable-abi="$abi" > /dev/null
+  # a noerr run would measure plain calls with either ABI
+  if ! grep -Eq 'define .*(\{ i32, i16 \}|i16) @run\(' "$out/$abi.ll"; then
+    echo "run wasn't compiled errable with --errable-abi=$abi" >&2
+    exit 1
+  fi
+  clang -O2 "$out/$abi.ll" -o "$out/$abi"
+
+  start=$(date +%s%N)
+  for ((i = 0; i < runs; ++i)); do
+    "$out/$abi"
+  done
+  end=$(date +%s%N)
+
+  echo "$abi: $(((end - start) / runs / 1000)) us per run"
+done
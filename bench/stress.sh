@@ -0,0 +1,73 @@
+#!/usr/bin/env bash
+# Compiles generated programs with huge expressions and deeply nested blocks
+# and prints the compile time per term. Linear compile time shows up as the
+# same time per term for every size.
+#
+# usage: bench/stress.sh [path to YALLL binary] [largest size]
+set -euo pipefail
+
+root="$(cd "$(dirname "$0")/.." && pwd)"
+yallc="${1:-$root/build/YALLL}"
+max="${2:-1000000}"
+out="$(mktemp -d)"
+trap 'rm -rf "$out"' EXIT
+
+# x + x + ... + x
+flat() {
+  awk -v n="$1" 'BEGIN {
+    printf "func noerr sum (i32 x) : i32 {\n  return x"
+    for (i = 1; i < n; ++i) printf " + x"
+    printf ";\n}\n\nfunc () : i32 {\n  return sum(0);\n}\n"
+  }'
+}
+
+# ((x + x) + x) + ... as a generator writing one term at a time would
+nested() {
+  awk -v n="$1" 'BEGIN {
+    printf "func noerr sum (i32 x) : i32 {\n  return "
+    for (i = 1; i < n; ++i) printf "("
+    printf "x"
+    for (i = 1; i < n; ++i) printf " + x)"
+    printf ";\n}\n\nfunc () : i32 {\n  return sum(0);\n}\n"
+  }'
+}
+
+# x + (x + (... + x)), recurses once per term everywhere
+right() {
+  awk -v n="$1" 'BEGIN {
+    printf "func noerr sum (i32 x) : i32 {\n  return "
+    for (i = 1; i < n; ++i) printf "x + ("
+    printf "x"
+    for (i = 1; i < n; ++i) printf ")"
+    printf ";\n}\n\nfunc () : i32 {\n  return sum(0);\n}\n"
+  }'
+}
+
+# if (x == 0) { if (x == 0) { ... } }
+blocks() {
+  awk -v n="$1" 'BEGIN {
+    printf "func noerr deep (i32 x) : i32 {\n"
+    for (i = 0; i < n; ++i) printf "if (x == 0) {\n"
+    for (i = 0; i < n; ++i) printf "}\n"
+    printf "return x;\n}\n\nfunc () : i32 {\n  return deep(0);\n}\n"
+  }'
+}
+
+# the nesting depth is bounded by --stack-size, not by the time it takes
+for kind in flat nested right blocks; do
+  for ((n = 1000; n <= max; n *= 10)); do
+    if [[ $kind != flat && $n -gt $((max / 10)) ]]; then break; fi
+
+    "$kind" "$n" > "$out/$kind.y"
+    start=$(date +%s%N)
+    # nesting beyond the stack size is an error, not a crash
+    if ! "$yallc" -f "$out/$kind.y" -o "$out/$kind.ll" > /dev/null 2>&1; then
+      echo "$kind $n: too deep for the stack, raise --stack-size"
+      break
+    fi
+    end=$(date +%s%N)
+
+    echo "$kind $n: $(((end - start) / 1000000)) ms," \
+      "$(((end - start) / n)) ns per term"
+  done
+done
@@ -0,0 +1,25 @@
+[negative, "The value became negative"]
+
+// acc never gets negative, but the check keeps add_one and run errable, so
+// every call goes through the errable ABI
+func add_one (i32 val) : i32 {
+  if (val < 0) {
+    reterr negative;
+  }
+  return val + 1;
+}
+
+func run (i32 n, i32 acc) : i32 {
+  if (n == 0) {
+    return acc;
+  }
+  return run(n - 1, add_one(acc));
+}
+
+func () : i32 {
+  i32 left = run(100000, 0) onerr {
+    default:
+      return 1;
+  };
+  return left - 100000;
+}
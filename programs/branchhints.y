@@ -0,0 +1,21 @@
+[negative, "The value is negative"]
+
+func check (i32 val) : i32 {
+  if unlikely (val < 0) {
+    reterr negative;
+  }
+  return val;
+}
+
+func () : i32 {
+  i32 val = 42;
+  if (expect(val == 42, true)) {
+    return 0;
+  } else likely (val > 0) {
+    return 1;
+  }
+  return check(val) onerr {
+    negative:
+      return 2;
+  };
+}
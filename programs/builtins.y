@@ -0,0 +1,22 @@
+func noerr hash (u32 val) : u32 {
+  u32 mixed = rotl(val, 13) * 2654435761;
+  return bswap(mixed) + popcount(val);
+}
+
+func noerr length (d64 x, d64 y) : d64 {
+  return builtin::sqrt(fma(x, x, y * y));
+}
+
+func noerr log2 (u64 val) : u64 {
+  return 63 - clz(val);
+}
+
+func () : i32 {
+  u64 start = cycle_counter();
+  u32 hashed = hash(42);
+  d64 len = length(3.0, 4.0);
+  i32x4 values = 7;
+  i32x4 limited = min(values, splat(5, 4));
+  u64 cycles = cycle_counter() - start;
+  return max(lane(limited, 0), 0);
+}
@@ -0,0 +1,14 @@
+[not_found, "The requested value was not found"]
+[out_of_range, "The value is out of range"]
+[too_big, "The value is out of range"]
+
+// a parameter shadows the error with the same name
+func noerr count (i32 not_found) : i32 {
+  return not_found + 1;
+}
+
+func () : i32 {
+  error err = not_found;
+  i32 too_big = 2;
+  return count(too_big);
+}
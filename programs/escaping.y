@@ -0,0 +1,14 @@
+[not_found, "The requested value was not found"]
+
+func find (i32 key) : i32 {
+  if (key < 0) {
+    reterr not_found;
+  }
+  return key;
+}
+
+// not_found escapes from main, it is reported on stderr and the program
+// exits with status 1
+func () : i32 {
+  return find(-1);
+}
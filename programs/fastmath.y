@@ -0,0 +1,22 @@
+@fastmath(reassoc, nnan)
+func noerr sum (d32x8 values) : d32 {
+  return reduce_add(values);
+}
+
+@fastmath
+func noerr clamp (d64 val, d64 limit) : d64 {
+  if (val > limit) {
+    return limit;
+  }
+  return val;
+}
+
+func () : i32 {
+  d32x8 values = 0.5;
+  d32 total = sum(values);
+  d64 clamped = clamp(3.5, 2.0);
+  @fastmath(contract) {
+    d64 fused = clamped * 2.0 + 1.0;
+  }
+  return 0;
+}
@@ -0,0 +1,74 @@
+func noerr sum_to (u32 n) : u32 {
+  !u32 sum = 0;
+  loop (!u32 i = 1; i <= n; i = i + 1) {
+    sum = sum + i;
+  }
+  return sum;
+}
+
+func noerr collatz_steps (!u64 n) : u32 {
+  !u32 steps = 0;
+  loop (n != 1) {
+    if (n % 2 == 0) {
+      n = n / 2;
+    } else {
+      n = 3 * n + 1;
+    }
+    steps = steps + 1;
+  }
+  return steps;
+}
+
+// found is assigned once, the iteration assigning it breaks out of the loop
+func noerr first_multiple (u32 start, u32 factor) : u32 {
+  u32 found;
+  !u32 i = start;
+  loop (;;) {
+    if (i % factor == 0) {
+      found = i;
+      break;
+    }
+    i = i + 1;
+  }
+  return found;
+}
+
+// a variable declared in the loop is a new one every iteration
+func noerr digit_sum (!u32 n) : u32 {
+  !u32 sum = 0;
+  loop (n > 0) {
+    u32 digit;
+    digit = n % 10;
+    sum = sum + digit;
+    n = n / 10;
+  }
+  return sum;
+}
+
+// b takes the value of a, which never changes in the loop
+func noerr copy_in_loop (u32 n) : u32 {
+  !u32 a = 5;
+  !u32 b = 0;
+  !u32 i = 0;
+  loop (i < n) {
+    b = a;
+    i = i + 1;
+  }
+  return a + b;
+}
+
+func () : i32 {
+  if (sum_to(10) != 55) {
+    return 1;
+  }
+  if (collatz_steps(27) != 111) {
+    return 2;
+  }
+  if (digit_sum(1234) != 10) {
+    return 3;
+  }
+  if (copy_in_loop(3) != 10) {
+    return 4;
+  }
+  return first_multiple(10, 7) - 14;
+}
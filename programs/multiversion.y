@@ -0,0 +1,17 @@
+@multiversion(avx2, "avx512f")
+func noerr dot (d32x16 a, d32x16 b) : d32 {
+  return reduce_add(a * b);
+}
+
+@multiversion(popcnt)
+func noerr bits (u64 val) : u64 {
+  return popcount(val);
+}
+
+func () : i32 {
+  d32x16 a = 1.5;
+  d32x16 b = 2.0;
+  d32 product = dot(a, b);
+  u64 set = bits(255);
+  return 0;
+}
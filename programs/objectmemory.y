@@ -0,0 +1,21 @@
+class Tazz {
+  public {
+    i32 value;
+  }
+}
+
+class Foo[1k] {
+  public {
+    i32 counter;
+
+    func noerr fizz() : i32 {
+      Tazz tazz_obj = new Tazz();
+      return 1;
+    }
+  }
+}
+
+func () : i32 {
+  Foo foo = new Foo();
+  return 0;
+}
@@ -0,0 +1,38 @@
+[not_found, "The requested value was not found"]
+[out_of_range, "The value is out of range"]
+[too_big, "The value is too big"]
+
+func find (i32 key) : i32 {
+  if (key < 0) {
+    reterr out_of_range;
+  }
+  if (key > 100) {
+    reterr too_big;
+  }
+  return key;
+}
+
+// errors of find that aren't handled escape from lookup
+func lookup (i32 key) : i32 {
+  i32 val = find(key);
+  return val * 2;
+}
+
+func noerr clamp (i32 key) : i32 {
+  return lookup(key) onerr {
+    // dead, neither find nor lookup return not_found
+    not_found:
+      return 0;
+    out_of_range:
+      return 0;
+    too_big:
+      return 200;
+  };
+}
+
+func () : i32 {
+  if (iserr lookup(-1)) {
+    return clamp(42);
+  }
+  return 1;
+}
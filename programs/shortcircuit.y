@@ -0,0 +1,28 @@
+func expensive (i32 val) : bool {
+  return val * val > 1000;
+}
+
+func square (i32 val) : i32 {
+  return val * val;
+}
+
+func () : i32 {
+  i32 a = 1;
+  i32 b = 5;
+  i32 c = 10;
+
+  // cheap operands are combined without branches
+  bool ordered = a < b < c;
+
+  // the call branches, the plain link after it still compares its result
+  bool squared = a < b < square(c) < 1000;
+
+  // expensive is only called if the lhs didn't decide the result
+  if (ordered && squared && expensive(c)) {
+    return 1;
+  }
+  if (a > b || expensive(b) || b / a > 2) {
+    return 2;
+  }
+  return 0;
+}
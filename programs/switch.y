@@ -0,0 +1,27 @@
+[not_found, "The requested value was not found"]
+[out_of_range, "The value is out of range"]
+
+func noerr days_in_month (u8 month) : u8 {
+  switch (month) {
+    2:
+      return 28;
+    4:
+    6:
+    9:
+    11:
+      return 30;
+    default:
+      return 31;
+  }
+}
+
+func () : i32 {
+  error err = not_found;
+  switch (err) {
+    not_found:
+      return 1;
+    out_of_range:
+      return 2;
+  }
+  return days_in_month(2);
+}
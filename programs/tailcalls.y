@@ -0,0 +1,30 @@
+// is_even and is_odd call each other before both are defined
+func noerr is_odd (u64 n) : bool
+
+func noerr is_even (u64 n) : bool {
+  if (n == 0) {
+    return true;
+  }
+  return @tailcall is_odd(n - 1);
+}
+
+func noerr is_odd (u64 n) : bool {
+  if (n == 0) {
+    return false;
+  }
+  return @tailcall is_even(n - 1);
+}
+
+func sum (u64 n, u64 acc) : u64 {
+  if (n == 0) {
+    return acc;
+  }
+  return @tailcall sum(n - 1, acc + n);
+}
+
+func () : i32 {
+  if (is_even(10000000)) {
+    return 0;
+  }
+  return 1;
+}
@@ -0,0 +1,30 @@
+func noerr dot (d32x4 a, d32x4 b) : d32 {
+  return reduce_add(a * b);
+}
+
+func noerr clamp (i32x8 values, i32 limit) : i32x8 {
+  return select(values > limit, splat(limit, 8), values);
+}
+
+func noerr lane_order () : i32x4 {
+  !i32x4 order = 0;
+  order = with_lane(order, 1, 1);
+  order = with_lane(order, 2, 2);
+  order = with_lane(order, 3, 3);
+  return order;
+}
+
+func () : i32 {
+  d32x4 a = 1.5;
+  d32x4 b = with_lane(a, 3, 2.0);
+  d32 product = dot(a, b);
+
+  i32x8 values = 42;
+  i32x8 clamped = clamp(values * 2, 50);
+  i32x4 order = lane_order();
+  i32x4 even = shuffle(order, order, 0, 2, 4, 6);
+  if (all(clamped == 50)) {
+    return reduce_max(even);
+  }
+  return lane(clamped, 0);
+}
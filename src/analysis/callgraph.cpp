@@ -0,0 +1,353 @@
+#include "callgraph.h"
+
+#include <algorithm>
+#include <functional>
+#include <stack>
+
+#include "../builtin/builtins.h"
+
+namespace analysis {
+
+bool ErrorSet::merge(const ErrorSet& other,
+                     const std::set<std::string>& handled) {
+  bool changed = !any && other.any;
+  any |= other.any;
+  for (auto& error : other.errors) {
+    if (handled.contains(error)) continue;
+    changed |= errors.insert(error).second;
+  }
+  return changed;
+}
+
+std::string ErrorSet::to_string() const {
+  std::string str;
+  for (auto& error : errors) {
+    str += (str.empty() ? "" : ", ") + error;
+  }
+  if (any) str += str.empty() ? "unknown errors" : " and unknown errors";
+  return str.empty() ? "no errors" : str;
+}
+
+// walks up the chain of rules with a single child, i.e. the precedence climb
+// of an operation without operators
+inline antlr4::tree::ParseTree* direct_operand_of(
+    YALLLParser::Function_callContext* call,
+    const std::function<bool(antlr4::tree::ParseTree*,
+                             antlr4::tree::ParseTree*)>& is_operand) {
+  antlr4::tree::ParseTree* child = call;
+  for (auto* node = call->parent; node; child = node, node = node->parent) {
+    if (is_operand(node, child)) return node;
+    if (node->children.size() != 1) return nullptr;
+  }
+  return nullptr;
+}
+
+YALLLParser::Iserr_opContext* checking_iserr(
+    YALLLParser::Function_callContext* call) {
+  return static_cast<YALLLParser::Iserr_opContext*>(direct_operand_of(
+      call, [](antlr4::tree::ParseTree* node, antlr4::tree::ParseTree* child) {
+        auto* iserr = dynamic_cast<YALLLParser::Iserr_opContext*>(node);
+        return iserr && iserr->op && iserr->val == child;
+      }));
+}
+
+YALLLParser::Onerr_opContext* handling_onerr(
+    YALLLParser::Function_callContext* call) {
+  return static_cast<YALLLParser::Onerr_opContext*>(direct_operand_of(
+      call, [](antlr4::tree::ParseTree* node, antlr4::tree::ParseTree* child) {
+        auto* onerr = dynamic_cast<YALLLParser::Onerr_opContext*>(node);
+        return onerr && onerr->op && onerr->lhs == child;
+      }));
+}
+
+void CallGraph::build(YALLLParser::ProgramContext* ctx,
+                      ErrorResolver resolve_error) {
+  logger->send_log("Building call graph");
+  ++*logger;
+  this->resolve_error = resolve_error;
+
+  for (auto* declaration : ctx->declaration()) {
+    if (auto* function_dec = declaration->function_dec()) {
+      add_declaration(function_dec, "");
+    }
+  }
+  for (auto* klass : ctx->class_()) {
+    auto owner = klass->name->getText();
+    for (auto* pp_block : klass->body->pp_block()) {
+      for (auto* declaration : pp_block->declaration()) {
+        if (auto* function_dec = declaration->function_dec()) {
+          add_declaration(function_dec, owner);
+        }
+      }
+    }
+  }
+
+  for (auto* definition : ctx->definition()) {
+    if (auto* function_def = definition->function_def()) {
+      add_function(function_def, "");
+    }
+  }
+  for (auto* klass : ctx->class_()) {
+    auto owner = klass->name->getText();
+    for (auto* pp_block : klass->body->pp_block()) {
+      for (auto* function_def : pp_block->function_def()) {
+        add_function(function_def, owner);
+      }
+    }
+  }
+
+  // errors escaping main end the program, they aren't returned to anybody
+  if (auto* entry_point = ctx->entry_point()) {
+    nodes.insert_or_assign(
+        "main", CallGraphNode{.name = "main",
+                              .line = entry_point->getStart()->getLine(),
+                              .explicit_noerr = false,
+                              .declared_only = false});
+    bodies.push_back(PendingBody{"main", entry_point->block(), ""});
+  }
+
+  // calls are only resolved once every function is known, a method can call
+  // a method that is defined after it
+  for (auto& pending : bodies) {
+    collect_calls(nodes.at(pending.name), pending.body, pending.owner);
+  }
+  bodies.clear();
+
+  find_recursion();
+
+  --*logger;
+}
+
+void CallGraph::add_declaration(YALLLParser::Function_decContext* ctx,
+                                const std::string& owner) {
+  auto name = ctx->NAME()->getText();
+  if (!owner.empty()) name = owner + "." + name;
+
+  // without a body every error is possible
+  bool noerr = ctx->NOERR_KW() != nullptr;
+  nodes.insert_or_assign(
+      name, CallGraphNode{.name = name,
+                          .line = ctx->getStart()->getLine(),
+                          .explicit_noerr = noerr,
+                          .declared_only = true,
+                          .raised = ErrorSet{.any = !noerr}});
+}
+
+void CallGraph::add_function(YALLLParser::Function_defContext* ctx,
+                             const std::string& owner) {
+  auto name = ctx->func_name->getText();
+  if (!owner.empty()) name = owner + "." + name;
+
+  // noerr of a declaration holds for its definition as well
+  bool noerr = ctx->NOERR_KW() != nullptr ||
+               (nodes.contains(name) && nodes.at(name).explicit_noerr);
+  bool exported = std::any_of(
+      ctx->annotations.begin(), ctx->annotations.end(),
+      [](auto* annotation) { return annotation->name->getText() == "export"; });
+  // errable values can hold any error
+  nodes.insert_or_assign(
+      name, CallGraphNode{
+                .name = name,
+                .line = ctx->func_name->getLine(),
+                .explicit_noerr = noerr,
+                .declared_only = false,
+                .raised = ErrorSet{.any = ctx->ret_type->errable != nullptr},
+                .exported = exported});
+  bodies.push_back(PendingBody{name, ctx->func_block, owner});
+}
+
+void CallGraph::collect_calls(CallGraphNode& node,
+                              antlr4::tree::ParseTree* body,
+                              const std::string& owner) {
+  std::stack<antlr4::tree::ParseTree*> todo;
+  todo.push(body);
+  while (!todo.empty()) {
+    auto* tree = todo.top();
+    todo.pop();
+
+    if (auto* reterr = dynamic_cast<YALLLParser::Reterr_opContext*>(tree)) {
+      if (reterr->op) {
+        // only the name of an error is known at compile time
+        auto error = resolve_error(reterr->val->getText(), owner);
+        if (error.empty())
+          node.raised.any = true;
+        else
+          node.raised.errors.insert(error);
+      }
+    }
+    auto* call = dynamic_cast<YALLLParser::Function_callContext*>(tree);
+    if (call && !is_builtin_call(call, owner)) {
+      auto callee = resolve(call->name->getText(), owner);
+      node.callees.push_back(callee);
+
+      if (auto* onerr = handling_onerr(call)) {
+        auto* handlers = onerr->rhs.front()->switch_();
+        if (!handlers->DEFAULT_KW()) {
+          EscapingCall escaping{callee};
+          for (auto* handler : handlers->cases) {
+            auto error = resolve_error(handler->label->getText(), owner);
+            if (!error.empty()) escaping.handled.insert(error);
+          }
+          node.escaping_calls.push_back(escaping);
+        }
+      } else if (!checking_iserr(call)) {
+        node.escaping_calls.push_back(EscapingCall{callee});
+      }
+    }
+
+    for (auto* child : tree->children) {
+      todo.push(child);
+    }
+  }
+}
+
+std::string CallGraph::resolve(const std::string& name,
+                               const std::string& owner) const {
+  // methods see the other methods of their class first
+  if (!owner.empty() && nodes.contains(owner + "." + name))
+    return owner + "." + name;
+  return name;
+}
+
+bool CallGraph::is_builtin_call(YALLLParser::Function_callContext* call,
+                                const std::string& owner) const {
+  // only builtin:: exists as namespace, a plain name is a builtin unless a
+  // function shadows it
+  if (call->scope) return true;
+  auto name = call->name->getText();
+  return !nodes.contains(resolve(name, owner)) && yalll::is_builtin(name);
+}
+
+void CallGraph::infer_noerr(bool infer) {
+  logger->send_log("Inferring error sets");
+  ++*logger;
+
+  for (auto& [name, node] : nodes) {
+    node.errors = node.raised;
+  }
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto& [name, node] : nodes) {
+      for (auto& call : node.escaping_calls) {
+        changed |= node.errors.merge(get_error_set(call.callee), call.handled);
+      }
+    }
+  }
+
+  for (auto& [name, node] : nodes) {
+    node.noerr = node.explicit_noerr || (infer && node.errors.empty());
+    if (node.declared_only) continue;
+
+    if (node.explicit_noerr && !node.errors.empty()) {
+      logger->send_error("noerr function {} in line {} can return {}", name,
+                         node.line, node.errors.to_string());
+    } else if (!node.explicit_noerr && node.noerr) {
+      logger->send_log("{} can't return errors, compiling it as noerr", name);
+    } else {
+      logger->send_log("{} can return {}", name, node.errors.to_string());
+    }
+  }
+
+  --*logger;
+}
+
+ErrorSet CallGraph::get_error_set(const std::string& name) const {
+  auto* node = find(name);
+  // unknown functions can return anything, noerr is a promise
+  if (!node) return ErrorSet{.any = true};
+  if (node->explicit_noerr) return ErrorSet{};
+  return node->errors;
+}
+
+void CallGraph::find_recursion() {
+  // Tarjan, every strongly connected component with more than one function
+  // or a function calling itself is a cycle
+  struct TarjanInfo {
+    size_t index;
+    size_t lowlink;
+    bool on_stack;
+  };
+  std::map<std::string, TarjanInfo> info;
+  std::vector<std::string> stack;
+  size_t next_index = 0;
+
+  std::function<void(const std::string&)> connect =
+      [&](const std::string& name) {
+        info[name] = TarjanInfo{next_index, next_index, true};
+        ++next_index;
+        stack.push_back(name);
+
+        for (auto& callee : nodes.at(name).callees) {
+          if (!nodes.contains(callee)) continue;
+
+          if (!info.contains(callee)) {
+            connect(callee);
+            info.at(name).lowlink =
+                std::min(info.at(name).lowlink, info.at(callee).lowlink);
+          } else if (info.at(callee).on_stack) {
+            info.at(name).lowlink =
+                std::min(info.at(name).lowlink, info.at(callee).index);
+          }
+        }
+
+        if (info.at(name).lowlink != info.at(name).index) return;
+
+        std::vector<std::string> component;
+        do {
+          component.push_back(stack.back());
+          info.at(stack.back()).on_stack = false;
+          stack.pop_back();
+        } while (component.back() != name);
+
+        auto& callees = nodes.at(name).callees;
+        bool calls_itself =
+            std::find(callees.begin(), callees.end(), name) != callees.end();
+        if (component.size() == 1 && !calls_itself) return;
+
+        for (auto& member : component) {
+          nodes.at(member).recursive = true;
+          logger->send_log("{} is recursive", member);
+        }
+      };
+
+  for (auto& [name, node] : nodes) {
+    if (!info.contains(name)) connect(name);
+  }
+}
+
+bool CallGraph::is_recursive(const std::string& name) const {
+  auto* node = find(name);
+  return node && node->recursive;
+}
+
+bool CallGraph::is_noerr(const std::string& name) const {
+  auto* node = find(name);
+  // unknown functions can't be proven to be error free
+  return node && node->noerr;
+}
+
+std::set<std::string> CallGraph::reachable(
+    const std::vector<std::string>& roots) const {
+  std::set<std::string> reached;
+  std::stack<std::string> todo;
+  for (auto& root : roots) {
+    todo.push(root);
+  }
+  while (!todo.empty()) {
+    auto name = todo.top();
+    todo.pop();
+    if (!nodes.contains(name) || !reached.insert(name).second) continue;
+
+    for (auto& callee : nodes.at(name).callees) {
+      todo.push(callee);
+    }
+  }
+  return reached;
+}
+
+const CallGraphNode* CallGraph::find(const std::string& name) const {
+  return nodes.contains(name) ? &nodes.at(name) : nullptr;
+}
+}  // namespace analysis
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../import/import.h"
+#include "../logging/logger.h"
+#include "YALLLParser.h"
+
+namespace analysis {
+
+struct ErrorSet {
+  // qualified names of the errors, i.e. Foo::error_a for errors of a class
+  std::set<std::string> errors;
+  // errors only known at runtime, i.e. reterr of a variable
+  bool any = false;
+
+  bool empty() const { return errors.empty() && !any; }
+  bool contains(const std::string& error) const {
+    return any || errors.contains(error);
+  }
+  // adds every error of other that isn't handled, returns if anything changed
+  bool merge(const ErrorSet& other, const std::set<std::string>& handled);
+  std::string to_string() const;
+};
+
+// a call whose errors aren't (completely) handled by the caller
+struct EscapingCall {
+  std::string callee;
+  // errors handled by an onerr without default, the rest escapes
+  std::set<std::string> handled;
+};
+
+struct CallGraphNode {
+  // llvm name of the function, Owner.name for methods
+  std::string name;
+  size_t line;
+
+  bool explicit_noerr;
+  // only declared, the body is unknown
+  bool declared_only;
+  // errors returned by the function itself using reterr
+  ErrorSet raised;
+  // every error that can escape the function, including the ones of callees
+  ErrorSet errors;
+  bool noerr = false;
+  // part of a cycle in the call graph, either calling itself or mutually
+  // recursive with other functions
+  bool recursive = false;
+  // @export, called from outside of the program
+  bool exported = false;
+
+  std::vector<std::string> callees;
+  std::vector<EscapingCall> escaping_calls;
+};
+
+// Whole program call graph, built from the parse tree before any code is
+// generated, so a function can be analysed before its callers are compiled.
+class CallGraph {
+ public:
+  // resolves the name of an error used in owner to its qualified name, empty
+  // if it isn't an error
+  using ErrorResolver =
+      std::function<std::string(const std::string&, const std::string&)>;
+
+  void build(YALLLParser::ProgramContext* ctx, ErrorResolver resolve_error);
+
+  // least fixpoint of the error sets over the call graph, every function
+  // starts without errors and collects the ones it raises and the ones that
+  // escape its callees. Functions ending up without any error are noerr, if
+  // infer is set, otherwise only the explicit noerr functions are.
+  void infer_noerr(bool infer = true);
+
+  bool is_noerr(const std::string& name) const;
+  bool is_recursive(const std::string& name) const;
+  // every error a call to name can return
+  ErrorSet get_error_set(const std::string& name) const;
+  const CallGraphNode* find(const std::string& name) const;
+  // every function transitively called by one of the roots, including them
+  std::set<std::string> reachable(const std::vector<std::string>& roots) const;
+  const std::map<std::string, CallGraphNode>& get_nodes() const {
+    return nodes;
+  }
+  // a plain name called in owner is a builtin unless a function of the
+  // program shadows it, the visitor resolves calls the same way
+  bool is_builtin_call(YALLLParser::Function_callContext* call,
+                       const std::string& owner) const;
+
+ private:
+  yalll::Import<util::Logger> logger;
+
+  std::map<std::string, CallGraphNode> nodes;
+  ErrorResolver resolve_error;
+
+  struct PendingBody {
+    std::string name;
+    antlr4::tree::ParseTree* body;
+    std::string owner;
+  };
+  std::vector<PendingBody> bodies;
+
+  void add_function(YALLLParser::Function_defContext* ctx,
+                    const std::string& owner);
+  void add_declaration(YALLLParser::Function_decContext* ctx,
+                       const std::string& owner);
+  void collect_calls(CallGraphNode& node, antlr4::tree::ParseTree* body,
+                     const std::string& owner);
+  std::string resolve(const std::string& name, const std::string& owner) const;
+  void find_recursion();
+};
+
+// the call is the direct operand of iserr or onerr
+YALLLParser::Iserr_opContext* checking_iserr(
+    YALLLParser::Function_callContext* call);
+YALLLParser::Onerr_opContext* handling_onerr(
+    YALLLParser::Function_callContext* call);
+}  // namespace analysis
@@ -0,0 +1,159 @@
+#include "effects.h"
+
+#include <llvm/ADT/SCCIterator.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/Analysis/CFG.h>
+#include <llvm/Analysis/CallGraph.h>
+#include <llvm/Analysis/ValueTracking.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/InstrTypes.h>
+#include <llvm/IR/Instructions.h>
+
+#include <algorithm>
+
+namespace analysis {
+
+void EffectAnalysis::run(llvm::Module& module) {
+  logger->send_log("Inferring function effects");
+  ++*logger;
+
+  // callees come before their callers, so their attributes are already known
+  llvm::CallGraph call_graph(module);
+  for (auto scc = llvm::scc_begin(&call_graph); !scc.isAtEnd(); ++scc) {
+    std::vector<llvm::Function*> component;
+    for (auto* node : *scc) {
+      auto* function = node->getFunction();
+      if (function && !function->isDeclaration()) component.push_back(function);
+    }
+    if (component.empty()) continue;
+
+    // recursion might never end
+    Effects effects;
+    effects.will_return = !scc.hasCycle();
+    for (auto* function : component) {
+      auto local = analyse(*function, component);
+      effects.memory |= local.memory;
+      effects.will_return &= local.will_return;
+      effects.no_sync &= local.no_sync;
+      effects.no_unwind &= local.no_unwind;
+      effects.speculatable &= local.speculatable;
+    }
+    for (auto* function : component) {
+      apply(*function, effects);
+    }
+  }
+
+  --*logger;
+}
+
+Effects EffectAnalysis::analyse(
+    llvm::Function& function, const std::vector<llvm::Function*>& component) {
+  Effects effects;
+  // a loop might never end
+  llvm::SmallVector<std::pair<const llvm::BasicBlock*, const llvm::BasicBlock*>>
+      backedges;
+  llvm::FindFunctionBackedges(function, backedges);
+  effects.will_return = backedges.empty();
+
+  for (auto& block : function) {
+    for (auto& instruction : block) {
+      if (instruction.isAtomic() || instruction.isVolatile()) {
+        effects.no_sync = false;
+      }
+
+      if (auto* load = llvm::dyn_cast<llvm::LoadInst>(&instruction)) {
+        add_access(effects, function, load->getPointerOperand(),
+                   llvm::ModRefInfo::Ref);
+      } else if (auto* store = llvm::dyn_cast<llvm::StoreInst>(&instruction)) {
+        add_access(effects, function, store->getPointerOperand(),
+                   llvm::ModRefInfo::Mod);
+      } else if (auto* call = llvm::dyn_cast<llvm::CallBase>(&instruction)) {
+        // the component is analysed as a whole
+        auto* callee = call->getCalledFunction();
+        if (callee && std::find(component.begin(), component.end(), callee) !=
+                          component.end()) {
+          continue;
+        }
+
+        effects.will_return &= call->hasFnAttr(llvm::Attribute::WillReturn);
+        effects.no_sync &= call->hasFnAttr(llvm::Attribute::NoSync);
+        effects.no_unwind &= call->doesNotThrow();
+        effects.speculatable &=
+            callee && callee->hasFnAttribute(llvm::Attribute::Speculatable);
+
+        // the argument memory of the callee is whatever our arguments point
+        // to, i.e. a global or our own stack frame, which doesn't count
+        auto call_memory = call->getMemoryEffects();
+        auto arg_access = call_memory.getModRef(llvm::MemoryEffects::ArgMem);
+        if (llvm::isModOrRefSet(arg_access)) {
+          for (auto& arg : call->args()) {
+            if (arg->getType()->isPointerTy()) {
+              add_access(effects, function, arg, arg_access);
+            }
+          }
+        }
+        effects.memory |=
+            call_memory.getWithoutLoc(llvm::MemoryEffects::ArgMem);
+      } else if (instruction.mayReadOrWriteMemory()) {
+        effects.memory = llvm::MemoryEffects::unknown();
+        effects.speculatable = false;
+      } else if (llvm::isa<llvm::UnreachableInst>(instruction) ||
+                 (!instruction.isTerminator() &&
+                  !llvm::isa<llvm::AllocaInst, llvm::PHINode>(instruction) &&
+                  !llvm::isSafeToSpeculativelyExecute(&instruction))) {
+        // i.e. a division by zero
+        effects.speculatable = false;
+      }
+    }
+  }
+  return effects;
+}
+
+void EffectAnalysis::add_access(Effects& effects, llvm::Function& function,
+                                llvm::Value* pointer,
+                                llvm::ModRefInfo access) {
+  auto* object = llvm::getUnderlyingObject(pointer);
+  // the stack frame dies together with the function
+  if (auto* alloca = llvm::dyn_cast<llvm::AllocaInst>(object);
+      alloca && alloca->getFunction() == &function) {
+    return;
+  }
+  // i.e. the ELUT, it never changes
+  if (auto* global = llvm::dyn_cast<llvm::GlobalVariable>(object);
+      global && global->isConstant() && !llvm::isModSet(access)) {
+    return;
+  }
+
+  // an argument could point anywhere, even to invalid memory
+  effects.speculatable = false;
+  if (llvm::isa<llvm::Argument>(object)) {
+    effects.memory |= llvm::MemoryEffects::argMemOnly(access);
+  } else {
+    effects.memory |= llvm::MemoryEffects(access);
+  }
+}
+
+void EffectAnalysis::apply(llvm::Function& function, Effects& effects) {
+  if (infer_memory) function.setMemoryEffects(effects.memory);
+  if (effects.will_return) function.addFnAttr(llvm::Attribute::WillReturn);
+  if (effects.no_sync) function.addFnAttr(llvm::Attribute::NoSync);
+  if (effects.no_unwind) function.addFnAttr(llvm::Attribute::NoUnwind);
+  // calls of speculatable functions can be hoisted anywhere, even out of
+  // branches that would never call them
+  bool speculatable = infer_memory && effects.speculatable &&
+                      effects.will_return &&
+                      effects.memory.doesNotAccessMemory();
+  if (speculatable) function.addFnAttr(llvm::Attribute::Speculatable);
+
+  logger->send_log("{}:{}{}{}{}{}{}", function.getName().str(),
+                   effects.memory.doesNotAccessMemory() ? " memory(none)"
+                   : effects.memory.onlyReadsMemory()   ? " readonly"
+                                                        : "",
+                   effects.memory.onlyAccessesArgPointees() ? " argmemonly"
+                                                            : "",
+                   effects.will_return ? " willreturn" : "",
+                   effects.no_sync ? " nosync" : "",
+                   effects.no_unwind ? " nounwind" : "",
+                   speculatable ? " speculatable" : "");
+}
+}  // namespace analysis
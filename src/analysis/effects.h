@@ -0,0 +1,55 @@
+#pragma once
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Support/ModRef.h>
+
+#include <vector>
+
+#include "../import/import.h"
+#include "../logging/logger.h"
+
+namespace analysis {
+
+// What a function can do besides computing its result. Memory of the
+// function's own stack frame and constant globals don't count.
+struct Effects {
+  llvm::MemoryEffects memory = llvm::MemoryEffects::none();
+  // no loops, no recursion and only callees that return as well
+  bool will_return = true;
+  // no atomics, no volatile accesses and only callees that don't sync
+  bool no_sync = true;
+  // YALLL itself never unwinds, only callees that aren't known to be
+  // nounwind, i.e. external ones, might
+  bool no_unwind = true;
+  // no instruction that could trap or is undefined for some arguments
+  bool speculatable = true;
+};
+
+// Interprocedural effect analysis on the generated IR
+// YALLL has neither exceptions nor a global heap, so most functions only
+// touch their own stack frame and the memory their arguments point to. The
+// functions are visited bottom up in the call graph, every strongly connected
+// component shares its effects. The results end up as function attributes
+// (nounwind, memory(...), willreturn, nosync, speculatable), so LLVM can CSE,
+// hoist and delete calls.
+class EffectAnalysis {
+ public:
+  // memory effects are skipped when the functions get instrumented later on,
+  // the counters are stores the attributes wouldn't know about
+  explicit EffectAnalysis(bool infer_memory) : infer_memory(infer_memory) {}
+
+  void run(llvm::Module& module);
+
+ private:
+  Effects analyse(llvm::Function& function,
+                  const std::vector<llvm::Function*>& component);
+  // accesses to the stack frame of function or constants are ignored
+  void add_access(Effects& effects, llvm::Function& function,
+                  llvm::Value* pointer, llvm::ModRefInfo access);
+  void apply(llvm::Function& function, Effects& effects);
+
+  yalll::Import<util::Logger> logger;
+  bool infer_memory;
+};
+}  // namespace analysis
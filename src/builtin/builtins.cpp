@@ -0,0 +1,12 @@
+#include "builtins.h"
+
+#include "../operation/intrinsicoperation.h"
+#include "../operation/vectoroperation.h"
+
+namespace yalll {
+
+bool is_builtin(const std::string& name) {
+  return IntrinsicOperation::from_name(name).has_value() ||
+         VectorOperation::from_name(name).has_value();
+}
+}  // namespace yalll
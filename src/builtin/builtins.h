@@ -0,0 +1,14 @@
+#pragma once
+
+#include <string>
+
+namespace yalll {
+
+// Builtins are lowered inline instead of being called, so they never return
+// errors and don't show up in the call graph. They live in the builtin
+// namespace (builtin::popcount(x)), but can be called without it as long as no
+// function of the same name exists.
+inline constexpr const char* BUILTIN_NAMESPACE = "builtin";
+
+bool is_builtin(const std::string& name);
+}  // namespace yalll
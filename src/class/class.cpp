@@ -0,0 +1,251 @@
+#include "class.h"
+
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/MDBuilder.h>
+
+#include <algorithm>
+
+namespace yalll {
+
+void Class::add_field(yalll::Value field) {
+  logger->send_log("Class {} got field {}", name, field.to_string());
+  fields.push_back(field);
+}
+
+llvm::StructType* Class::generate_type(llvm::Module& module) {
+  auto& context = module.getContext();
+
+  std::vector<llvm::Type*> elements;
+  for (auto& field : fields) {
+    elements.push_back(field.type_info.get_llvm_type());
+  }
+
+  // object memory is appended after the fields: { fields..., offset, data }
+  if (has_object_memory()) {
+    elements.push_back(llvm::Type::getInt64Ty(context));
+    elements.push_back(llvm::ArrayType::get(llvm::Type::getInt8Ty(context),
+                                            object_memory_size));
+  }
+
+  // recompiling in --watch mode finds the type of the last compilation, it
+  // can be shared if the class didn't change
+  auto* existing = llvm::StructType::getTypeByName(context, name);
+  if (existing && existing->elements() == llvm::ArrayRef(elements)) {
+    llvm_type = existing;
+  } else {
+    llvm_type = llvm::StructType::create(context, elements, name);
+  }
+  logger->send_log("Generated type for class {} with {} bytes object memory",
+                   name, object_memory_size);
+  return llvm_type;
+}
+
+void Class::generate_object_memory(llvm::Module& module) {
+  if (!has_object_memory()) return;
+
+  auto& context = module.getContext();
+  auto* i64 = llvm::Type::getInt64Ty(context);
+  auto* ptr = llvm::PointerType::get(context, 0);
+  llvm::IRBuilder<> om_builder(context);
+
+  // ptr om_alloc(ptr self, i64 size, i64 align)
+  om_alloc = llvm::Function::Create(
+      llvm::FunctionType::get(ptr, {ptr, i64, i64}, false),
+      llvm::Function::InternalLinkage, name + ".om_alloc", module);
+  om_alloc->addFnAttr(llvm::Attribute::AlwaysInline);
+  auto* self = om_alloc->getArg(0);
+  auto* size = om_alloc->getArg(1);
+  auto* align = om_alloc->getArg(2);
+  self->setName("self");
+  size->setName("size");
+  align->setName("align");
+
+  auto* entry = llvm::BasicBlock::Create(context, "entry", om_alloc);
+  auto* overflow = llvm::BasicBlock::Create(context, "overflow", om_alloc);
+  auto* bump = llvm::BasicBlock::Create(context, "bump", om_alloc);
+
+  om_builder.SetInsertPoint(entry);
+  auto* offset_ptr =
+      om_builder.CreateStructGEP(llvm_type, self, offset_index(), "offset_ptr");
+  auto* data_ptr =
+      om_builder.CreateStructGEP(llvm_type, self, offset_index() + 1, "data");
+  auto* offset = om_builder.CreateLoad(i64, offset_ptr, "offset");
+
+  // align the absolute address, not the offset, the object itself is only
+  // guaranteed to be aligned to OBJECT_MEMORY_ALIGNMENT
+  auto* base = om_builder.CreatePtrToInt(data_ptr, i64, "base");
+  auto* unaligned = om_builder.CreateAdd(
+      om_builder.CreateAdd(base, offset),
+      om_builder.CreateSub(align, llvm::ConstantInt::get(i64, 1)));
+  auto* aligned = om_builder.CreateAnd(unaligned, om_builder.CreateNeg(align),
+                                       "aligned");
+  auto* start = om_builder.CreateSub(aligned, base, "start");
+  auto* end = om_builder.CreateAdd(start, size, "end");
+
+  llvm::MDBuilder md_builder(context);
+  om_builder.CreateCondBr(
+      om_builder.CreateICmpUGT(end,
+                               llvm::ConstantInt::get(i64, object_memory_size)),
+      overflow, bump, md_builder.createBranchWeights(1, 2000));
+
+  // running out of object memory can't be handled, so we panic
+  om_builder.SetInsertPoint(overflow);
+  om_builder.CreateIntrinsic(llvm::Intrinsic::trap, {}, {});
+  om_builder.CreateUnreachable();
+
+  om_builder.SetInsertPoint(bump);
+  om_builder.CreateStore(end, offset_ptr);
+  om_builder.CreateRet(
+      om_builder.CreateInBoundsGEP(om_builder.getInt8Ty(), data_ptr, start));
+
+  // void om_reset(ptr self)
+  om_reset = llvm::Function::Create(
+      llvm::FunctionType::get(om_builder.getVoidTy(), {ptr}, false),
+      llvm::Function::InternalLinkage, name + ".om_reset", module);
+  om_reset->addFnAttr(llvm::Attribute::AlwaysInline);
+  om_reset->getArg(0)->setName("self");
+
+  om_builder.SetInsertPoint(
+      llvm::BasicBlock::Create(context, "entry", om_reset));
+  om_builder.CreateStore(
+      llvm::ConstantInt::get(i64, 0),
+      om_builder.CreateStructGEP(llvm_type, om_reset->getArg(0),
+                                 offset_index(), "offset_ptr"));
+  om_builder.CreateRetVoid();
+}
+
+llvm::Value* Class::generate_alloc(llvm::Value* self, llvm::Type* type,
+                                   const llvm::DataLayout& layout) {
+  if (!om_alloc) {
+    logger->send_internal_error("Class {} has no object memory to allocate from",
+                                name);
+    return nullptr;
+  }
+
+  Import<llvm::IRBuilder<>> builder;
+  uint64_t align = std::max<uint64_t>(layout.getABITypeAlign(type).value(),
+                                      OBJECT_MEMORY_ALIGNMENT);
+  return builder->CreateCall(
+      om_alloc, {self, builder->getInt64(layout.getTypeAllocSize(type)),
+                 builder->getInt64(align)});
+}
+
+void Class::generate_reset(llvm::Value* self) {
+  if (!om_reset) return;
+
+  Import<llvm::IRBuilder<>> builder;
+  builder->CreateCall(om_reset, {self});
+}
+
+void Class::register_allocation(const std::string& method_name, Class& target,
+                                size_t line, bool bounded,
+                                const llvm::DataLayout& layout) {
+  auto* type = target.get_llvm_type();
+  uint64_t align = std::max<uint64_t>(layout.getABITypeAlign(type).value(),
+                                      OBJECT_MEMORY_ALIGNMENT);
+  // worst case includes the padding needed to align the allocation
+  uint64_t worst_case_size = layout.getTypeAllocSize(type) + align - 1;
+
+  allocations.push_back(ObjectAllocation{target.get_name(), method_name,
+                                         worst_case_size, line, bounded});
+}
+
+void Class::register_method_call(const std::string& caller,
+                                 const std::string& callee, bool bounded) {
+  method_calls.push_back(MethodCall{caller, callee, bounded});
+}
+
+std::set<std::string> Class::repeated_methods() const {
+  // methods that no other method calls run once per object, a method runs
+  // more than once if it's called in a loop, from two places or by a
+  // method that runs more than once, which includes recursion
+  std::map<std::string, size_t> call_sites;
+  std::set<std::string> repeated;
+  for (auto& call : method_calls) {
+    if (!call.bounded || ++call_sites[call.callee] > 1)
+      repeated.insert(call.callee);
+  }
+
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto& call : method_calls) {
+      if (repeated.contains(call.caller) &&
+          repeated.insert(call.callee).second) {
+        changed = true;
+      }
+    }
+  }
+
+  // a cycle without outside callers has a single call site per method
+  std::map<std::string, std::set<std::string>> reaches;
+  for (auto& call : method_calls) reaches[call.caller].insert(call.callee);
+  changed = true;
+  while (changed) {
+    changed = false;
+    for (auto& [caller, callees] : reaches) {
+      auto size = callees.size();
+      for (auto callee : std::set<std::string>(callees)) {
+        if (callee != caller && reaches.contains(callee))
+          callees.insert(reaches[callee].begin(), reaches[callee].end());
+      }
+      changed |= callees.size() != size;
+    }
+  }
+  for (auto& [caller, callees] : reaches) {
+    if (!callees.contains(caller)) continue;
+    repeated.insert(caller);
+    repeated.insert(callees.begin(), callees.end());
+  }
+  return repeated;
+}
+
+bool Class::check_object_memory_bound() {
+  if (allocations.empty()) return true;
+
+  if (!has_object_memory()) {
+    for (auto& allocation : allocations) {
+      logger->send_error(
+          "new {} in line {} needs object memory, but class {} has none",
+          allocation.class_name, allocation.line, name);
+    }
+    return false;
+  }
+
+  // nothing is freed before the object dies, so every allocation adds up
+  // over the lifetime of the object, no matter which method made it
+  auto repeated = repeated_methods();
+  uint64_t usage = 0;
+  for (auto& allocation : allocations) {
+    if (!allocation.bounded) {
+      logger->send_warning(
+          "Can't bound new {} in line {}, object memory of {} may overflow",
+          allocation.class_name, allocation.line, name);
+      continue;
+    }
+    if (repeated.contains(allocation.method_name)) {
+      logger->send_warning(
+          "Can't bound new {} in line {}, {}.{} can run more than once per "
+          "object, object memory of {} may overflow",
+          allocation.class_name, allocation.line, name, allocation.method_name,
+          name);
+      continue;
+    }
+    usage += allocation.worst_case_size;
+  }
+
+  if (usage > object_memory_size) {
+    logger->send_error(
+        "Objects of {} need up to {} bytes, but object memory is only {} bytes",
+        name, usage, object_memory_size);
+    return false;
+  }
+  logger->send_log("Objects of {} need up to {} of {} bytes object memory",
+                   name, usage, object_memory_size);
+  return true;
+}
+
+}  // namespace yalll
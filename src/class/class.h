@@ -0,0 +1,91 @@
+#pragma once
+
+#include <llvm/IR/DataLayout.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Module.h>
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "../import/import.h"
+#include "../logging/logger.h"
+#include "../value/value.h"
+
+namespace yalll {
+
+// A single `new` inside a method of the class owning the object memory
+struct ObjectAllocation {
+  std::string class_name;
+  std::string method_name;
+  uint64_t worst_case_size;
+  size_t line;
+  bool bounded;
+};
+
+// A method of the class calling another one on the same object
+struct MethodCall {
+  std::string caller;
+  std::string callee;
+  bool bounded;
+};
+
+// Every instance of a class with a size (`class Foo[1k]`) carries its own
+// object memory. The memory is an in-object region that `new` bump allocates
+// from in O(1). Nothing is ever freed on its own, the whole region dies (or
+// is reset) together with the object owning it.
+class Class {
+ public:
+  static constexpr uint64_t OBJECT_MEMORY_ALIGNMENT = 16;
+
+  Class(std::string name, uint64_t object_memory_size)
+      : name(name), object_memory_size(object_memory_size) {}
+
+  void add_field(yalll::Value field);
+
+  llvm::StructType* generate_type(llvm::Module& module);
+  void generate_object_memory(llvm::Module& module);
+
+  // returns a pointer to fresh memory for an instance of type inside the
+  // object memory of self
+  llvm::Value* generate_alloc(llvm::Value* self, llvm::Type* type,
+                              const llvm::DataLayout& layout);
+  void generate_reset(llvm::Value* self);
+
+  void register_allocation(const std::string& method_name, Class& target,
+                           size_t line, bool bounded,
+                           const llvm::DataLayout& layout);
+  // bounded is false for calls that can repeat, i.e. inside of loops
+  void register_method_call(const std::string& caller,
+                            const std::string& callee, bool bounded);
+  // statically bounds the usage over the lifetime of an object, the memory is
+  // only reclaimed with the object. Reports the allocations that can overflow
+  // the object memory or run more than once per object.
+  bool check_object_memory_bound();
+
+  std::string& get_name() { return name; }
+  uint64_t get_object_memory_size() const { return object_memory_size; }
+  bool has_object_memory() const { return object_memory_size > 0; }
+  llvm::StructType* get_llvm_type() { return llvm_type; }
+  std::vector<yalll::Value>& get_fields() { return fields; }
+
+ private:
+  Import<util::Logger> logger;
+
+  std::string name;
+  uint64_t object_memory_size;
+  std::vector<yalll::Value> fields;
+  std::vector<ObjectAllocation> allocations;
+  std::vector<MethodCall> method_calls;
+
+  llvm::StructType* llvm_type = nullptr;
+  llvm::Function* om_alloc = nullptr;
+  llvm::Function* om_reset = nullptr;
+
+  unsigned offset_index() const { return fields.size(); }
+  std::set<std::string> repeated_methods() const;
+};
+}  // namespace yalll
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/LLVMContext.h>
+
+#include <iostream>
+#include <ostream>
+
+#include "../logging/logger.h"
+#include "compileroptions.h"
+
+namespace yallc {
+
+// Everything a compilation imports through yalll::Import. While a context is
+// active on a thread, every Import on that thread resolves to it, so
+// compilations with different contexts don't share anything and can run on
+// different threads at the same time.
+class CompilationContext {
+ public:
+  CompilationContext(const CompilerOptions& options,
+                     std::ostream& out = std::cout,
+                     std::ostream& err = std::cerr)
+      : builder(context), logger(out, err), options(options) {}
+  CompilationContext(const CompilationContext&) = delete;
+  CompilationContext& operator=(const CompilationContext&) = delete;
+
+  // the context stays active on the thread until the activation is gone
+  class Activation {
+   public:
+    explicit Activation(CompilationContext& context);
+    ~Activation();
+    Activation(const Activation&) = delete;
+    Activation& operator=(const Activation&) = delete;
+
+   private:
+    CompilationContext* previous;
+  };
+
+  // outside of any compilation the thread has a default context
+  static CompilationContext& active();
+
+  llvm::LLVMContext context;
+  llvm::IRBuilder<> builder;
+  util::Logger logger;
+  CompilerOptions options;
+};
+}  // namespace yallc
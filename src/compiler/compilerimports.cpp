@@ -6,24 +6,48 @@
 #include <llvm/Support/raw_ostream.h>
 
 #include "../logging/logger.h"
+#include "compilationcontext.h"
+#include "compileroptions.h"
 
 #include "../import/import.h"
 
+// everything is taken from the context that is active on the calling thread,
+// see CompilationContext
+
+namespace yallc {
+
+static thread_local CompilationContext* active_context = nullptr;
+
+CompilationContext::Activation::Activation(CompilationContext& context)
+    : previous(active_context) {
+  active_context = &context;
+}
+
+CompilationContext::Activation::~Activation() { active_context = previous; }
+
+CompilationContext& CompilationContext::active() {
+  if (active_context) return *active_context;
+  thread_local CompilationContext fallback{CompilerOptions()};
+  return fallback;
+}
+}  // namespace yallc
+
 template <>
 llvm::LLVMContext& yalll::Import<llvm::LLVMContext>::get_instance() {
-  static llvm::LLVMContext context;
-  return context;
+  return yallc::CompilationContext::active().context;
 }
 
 template <>
 llvm::IRBuilder<>& yalll::Import<llvm::IRBuilder<>>::get_instance() {
-  yalll::Import<llvm::LLVMContext> context;
-  static llvm::IRBuilder<> builder(*context);
-  return builder;
+  return yallc::CompilationContext::active().builder;
 }
 
 template <>
 util::Logger& yalll::Import<util::Logger>::get_instance() {
-  static util::Logger logger;
-  return logger;
+  return yallc::CompilationContext::active().logger;
+}
+
+template <>
+yallc::CompilerOptions& yalll::Import<yallc::CompilerOptions>::get_instance() {
+  return yallc::CompilationContext::active().options;
 }
@@ -0,0 +1,154 @@
+#include "compilerinstance.h"
+
+#include <ANTLRInputStream.h>
+#include <BaseErrorListener.h>
+#include <CommonTokenFactory.h>
+#include <CommonTokenStream.h>
+#include <Exceptions.h>
+#include <UnbufferedCharStream.h>
+#include <UnbufferedTokenStream.h>
+#include <llvm/Support/thread.h>
+
+#include <fstream>
+
+#include "../import/import.h"
+#include "YALLLLexer.h"
+#include "YALLLParser.h"
+#include "nestinglimit.h"
+#include "parseprofile.h"
+#include "visitor_impl.h"
+
+namespace yallc {
+
+// syntax errors are diagnostics of the instance like any other error, not
+// printed to std::cerr by antlr
+class SyntaxErrorListener : public antlr4::BaseErrorListener {
+ public:
+  void syntaxError(antlr4::Recognizer* recognizer,
+                   antlr4::Token* offending_symbol, size_t line,
+                   size_t char_position, const std::string& msg,
+                   std::exception_ptr e) override {
+    logger->send_error("Syntax error in line {}:{}, {}", line, char_position,
+                       msg);
+  }
+
+ private:
+  yalll::Import<util::Logger> logger;
+};
+
+inline void report_syntax_errors(antlr4::Recognizer& recognizer,
+                                 SyntaxErrorListener& listener) {
+  recognizer.removeErrorListeners();
+  recognizer.addErrorListener(&listener);
+}
+
+bool CompilerInstance::compile(const std::string& source_path,
+                               const std::string& out_path,
+                               IncrementalCache* cache) {
+  auto errors_before = context.logger.get_error_count();
+
+  // parsing, visiting and generating recurse once per nesting level of the
+  // source, generated sources need more stack than the caller may have
+  llvm::thread compiler(context.options.stack_size, [&]() {
+    CompilationContext::Activation activation(context);
+    if (context.options.stream)
+      stream_program(source_path, out_path);
+    else
+      compile_program(source_path, out_path, cache);
+  });
+  compiler.join();
+  return context.logger.get_error_count() == errors_before;
+}
+
+void CompilerInstance::compile_program(const std::string& source_path,
+                                       const std::string& out_path,
+                                       IncrementalCache* cache) {
+  yalll::Import<util::Logger> logger;
+  logger->get_out() << "Loading: " << source_path << std::endl;
+
+  std::ifstream stream(source_path);
+  if (!stream.good()) {
+    logger->send_error("Can't open {}", source_path);
+    return;
+  }
+
+  antlr4::ANTLRInputStream input(stream);
+  YALLLLexer lexer(&input);
+  antlr4::CommonTokenStream tokens(&lexer);
+  YALLLParser parser(&tokens);
+  SyntaxErrorListener syntax_errors;
+  report_syntax_errors(lexer, syntax_errors);
+  report_syntax_errors(parser, syntax_errors);
+  NestingLimit nesting_limit(context.options.stack_size);
+  parser.addParseListener(&nesting_limit);
+
+  if (context.options.parse_profile) parser.setProfile(true);
+
+  YALLLParser::ProgramContext* ast;
+  try {
+    ast = parser.program();
+  } catch (const antlr4::ParseCancellationException&) {
+    return;
+  }
+  logger->get_out() << ast->getText() << std::endl;
+  if (context.options.parse_profile)
+    print_parse_profile(parser, logger->get_out());
+
+  YALLLVisitorImpl visitor(out_path, source_path, cache);
+  visitor.visit(ast);
+}
+
+// --stream, parses and compiles one top level item at a time, so only the
+// tokens and the tree of a single item are in memory at once
+void CompilerInstance::stream_program(const std::string& source_path,
+                                      const std::string& out_path) {
+  yalll::Import<util::Logger> logger;
+  logger->get_out() << "Streaming: " << source_path << std::endl;
+
+  std::wifstream stream(source_path);
+  if (!stream.good()) {
+    logger->send_error("Can't open {}", source_path);
+    return;
+  }
+
+  antlr4::UnbufferedCharStream input(stream);
+  YALLLLexer lexer(&input);
+  // the char stream only keeps a window of the source, tokens have to keep
+  // their own text
+  antlr4::CommonTokenFactory token_factory(true);
+  lexer.setTokenFactory(&token_factory);
+  antlr4::UnbufferedTokenStream tokens(&lexer);
+  YALLLParser parser(&tokens);
+  SyntaxErrorListener syntax_errors;
+  report_syntax_errors(lexer, syntax_errors);
+  report_syntax_errors(parser, syntax_errors);
+  NestingLimit nesting_limit(context.options.stack_size);
+  parser.addParseListener(&nesting_limit);
+
+  if (context.options.parse_profile) parser.setProfile(true);
+
+  YALLLVisitorImpl visitor(out_path, source_path);
+  visitor.begin_stream();
+  while (tokens.LA(1) != antlr4::Token::EOF) {
+    // the tree points into the token buffer, the mark keeps the tokens of
+    // the item alive until the tree is gone
+    auto marker = tokens.mark();
+    auto start = tokens.index();
+    YALLLParser::Top_levelContext* item;
+    try {
+      item = parser.top_level();
+    } catch (const antlr4::ParseCancellationException&) {
+      return;
+    }
+    visitor.visit_top_level(item);
+
+    parser.getTreeTracker().reset();
+    // a syntax error can leave the item empty
+    if (tokens.index() == start) tokens.consume();
+    tokens.release(marker);
+  }
+  visitor.end_stream();
+  if (context.options.parse_profile)
+    print_parse_profile(parser, logger->get_out());
+}
+}  // namespace yallc
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <iostream>
+#include <ostream>
+#include <string>
+
+#include "compilationcontext.h"
+#include "compileroptions.h"
+#include "incremental.h"
+
+namespace yallc {
+
+// The compiler as a library (libyallc). An instance owns its compilation
+// context, i.e. its LLVM context, builder, diagnostics and options, so any
+// number of instances can compile on different threads at once. A single
+// instance compiles one program at a time.
+class CompilerInstance {
+ public:
+  explicit CompilerInstance(const CompilerOptions& options,
+                            std::ostream& out = std::cout,
+                            std::ostream& err = std::cerr)
+      : context(options, out, err) {}
+
+  // compiles the source into LLVM IR at out_path, false if there were
+  // errors. A cache reuses the unchanged functions of the last compilation
+  // of the same instance.
+  bool compile(const std::string& source_path, const std::string& out_path,
+               IncrementalCache* cache = nullptr);
+
+  const CompilerOptions& get_options() const { return context.options; }
+  size_t get_error_count() const { return context.logger.get_error_count(); }
+
+ private:
+  void compile_program(const std::string& source_path,
+                       const std::string& out_path, IncrementalCache* cache);
+  void stream_program(const std::string& source_path,
+                      const std::string& out_path);
+
+  CompilationContext context;
+};
+}  // namespace yallc
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <string>
+
+namespace yallc {
+
+// How errable functions hand their result back to the caller
+enum class ErrableABI {
+  // {T, i16} is returned as first class aggregate in registers, results that
+  // don't fit fall back to the return pointer
+  Registers,
+  // the caller passes a pointer to stack space for T, only the error id is
+  // returned
+  ReturnPointer,
+};
+
+struct CompilerOptions {
+  ErrableABI errable_abi = ErrableABI::Registers;
+  // compile functions that provably can't return errors as noerr
+  bool infer_noerr = true;
+  // mark functions readonly, willreturn, ... where the generated IR proves it
+  bool infer_effects = true;
+
+  // -O<n>
+  unsigned opt_level = 0;
+  // --whole-program, the module is the whole program, only main and @export
+  // functions are visible outside of it
+  bool whole_program = false;
+  // --reachable-only, functions that neither main nor an @export function
+  // can reach are neither checked nor compiled
+  bool reachable_only = false;
+  // PGO, either instrument the program or use a merged profile
+  bool profile_generate = false;
+  std::string profile_generate_path = "default_%m.profraw";
+  std::string profile_use;
+
+  // --stack-size, the compiler runs on a thread with this much stack, deeply
+  // nested sources recurse deeply as well
+  unsigned stack_size = 1024u << 20;
+  // --jobs, the top level functions are generated by this many threads
+  unsigned jobs = 1;
+
+  // --parse-profile, prints the cost of every grammar decision after parsing
+  bool parse_profile = false;
+  // --stream, parses and compiles one top level item at a time, the tokens
+  // and the tree of an item are dropped once it's compiled
+  bool stream = false;
+
+  // -g, DWARF line tables
+  bool debug_info = false;
+  // keep the frame pointer in every function, sampling profilers can walk
+  // the stack without unwind tables
+  bool frame_pointer = false;
+
+  // --target-cpu / --target-features, native means the host, empty the
+  // defaults of the triple
+  std::string target_cpu;
+  std::string target_features;
+
+  // --fast-math, the fast math flags every float instruction gets, empty
+  // means strict IEEE semantics
+  std::string fast_math;
+};
+}  // namespace yallc
@@ -0,0 +1,27 @@
+#include "fastmath.h"
+
+namespace yallc {
+
+bool add_fast_math_flag(llvm::FastMathFlags& flags, const std::string& name) {
+  if (name == "fast") {
+    flags.setFast();
+  } else if (name == "reassoc") {
+    flags.setAllowReassoc();
+  } else if (name == "nnan") {
+    flags.setNoNaNs();
+  } else if (name == "ninf") {
+    flags.setNoInfs();
+  } else if (name == "nsz") {
+    flags.setNoSignedZeros();
+  } else if (name == "arcp") {
+    flags.setAllowReciprocal();
+  } else if (name == "contract") {
+    flags.setAllowContract();
+  } else if (name == "afn") {
+    flags.setApproxFunc();
+  } else {
+    return false;
+  }
+  return true;
+}
+}  // namespace yallc
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <llvm/IR/FMF.h>
+
+#include <string>
+
+namespace yallc {
+
+// --fast-math=reassoc,nnan and @fastmath(reassoc, nnan) use the names of the
+// LLVM flags, fast enables all of them. False for unknown names.
+bool add_fast_math_flag(llvm::FastMathFlags& flags, const std::string& name);
+}  // namespace yallc
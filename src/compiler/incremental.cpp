@@ -0,0 +1,135 @@
+#include "incremental.h"
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/ValueMapper.h>
+
+namespace yallc {
+
+// private constants like strings are numbered in the order they're created,
+// the same name can mean different contents in the next compilation. They
+// are matched by content instead, and copied if the new module has none.
+inline bool matched_by_content(const llvm::GlobalValue& global) {
+  auto* variable = llvm::dyn_cast<llvm::GlobalVariable>(&global);
+  return variable && variable->hasLocalLinkage() && variable->isConstant() &&
+         variable->hasInitializer();
+}
+
+// every other global is matched by name between two modules
+inline bool matchable_globals(llvm::Function& function) {
+  for (auto& inst : llvm::instructions(function)) {
+    for (auto& operand : inst.operands()) {
+      auto* global = llvm::dyn_cast<llvm::GlobalValue>(operand);
+      if (global && !global->hasName() && !matched_by_content(*global))
+        return false;
+    }
+  }
+  return true;
+}
+
+void IncrementalCache::begin(size_t interface_hash) {
+  reusable = snapshot && this->interface_hash == interface_hash;
+  this->interface_hash = interface_hash;
+  if (snapshot && !reusable) {
+    logger->send_log("Interface of the program changed, compiling everything");
+  }
+  next_source_hashes.clear();
+  reused.clear();
+}
+
+bool IncrementalCache::reuse(const std::string& name, size_t source_hash) {
+  next_source_hashes.insert_or_assign(name, source_hash);
+  if (!reusable || !source_hashes.contains(name) ||
+      source_hashes.at(name) != source_hash) {
+    return false;
+  }
+
+  auto* previous = snapshot->getFunction(name);
+  if (!previous || previous->isDeclaration() ||
+      !matchable_globals(*previous)) {
+    return false;
+  }
+  logger->send_log("{} didn't change, reusing it", name);
+  reused.push_back(name);
+  return true;
+}
+
+void IncrementalCache::generate_reused(llvm::Module& module) {
+  if (reused.empty()) return;
+
+  std::map<llvm::Constant*, llvm::GlobalVariable*> constants;
+  for (auto& variable : module.globals()) {
+    if (matched_by_content(variable))
+      constants.try_emplace(variable.getInitializer(), &variable);
+  }
+
+  std::vector<llvm::GlobalVariable*> copies;
+  llvm::ValueToValueMapTy value_map;
+  for (auto& global : snapshot->global_values()) {
+    if (matched_by_content(global)) {
+      auto& variable = llvm::cast<llvm::GlobalVariable>(global);
+      auto [it, inserted] =
+          constants.try_emplace(variable.getInitializer(), nullptr);
+      if (inserted) {
+        it->second = new llvm::GlobalVariable(
+            module, variable.getValueType(), true, variable.getLinkage(),
+            variable.getInitializer(), variable.getName());
+        it->second->copyAttributesFrom(&variable);
+        copies.push_back(it->second);
+      }
+      value_map[&global] = it->second;
+      continue;
+    }
+
+    auto* target = module.getNamedValue(global.getName());
+    // intrinsics are only declared once something uses them
+    auto* function = llvm::dyn_cast<llvm::Function>(&global);
+    if (!target && function && function->isIntrinsic()) {
+      target = llvm::Function::Create(function->getFunctionType(),
+                                      function->getLinkage(),
+                                      function->getName(), module);
+      llvm::cast<llvm::Function>(target)->copyAttributesFrom(function);
+    }
+    if (target) value_map[&global] = target;
+  }
+
+  for (auto& name : reused) {
+    auto* previous = snapshot->getFunction(name);
+    auto* function = module.getFunction(name);
+    if (!function || !function->isDeclaration()) {
+      logger->send_internal_error("Can't reuse {}, it has no declaration",
+                                  name);
+      continue;
+    }
+
+    auto arg = function->arg_begin();
+    for (auto& previous_arg : previous->args()) {
+      value_map[&previous_arg] = &*arg++;
+    }
+    llvm::SmallVector<llvm::ReturnInst*, 4> returns;
+    llvm::CloneFunctionInto(function, previous, value_map,
+                            llvm::CloneFunctionChangeType::DifferentModule,
+                            returns);
+  }
+  // only the constants of the reused functions were needed
+  for (auto* copy : copies) {
+    copy->removeDeadConstantUsers();
+    if (copy->use_empty()) copy->eraseFromParent();
+  }
+  logger->send_log("Reused {} functions of the last compilation",
+                   reused.size());
+}
+
+void IncrementalCache::finish(const llvm::Module& module, bool failed) {
+  if (failed) {
+    snapshot.reset();
+    source_hashes.clear();
+    return;
+  }
+  snapshot = llvm::CloneModule(module);
+  source_hashes = std::move(next_source_hashes);
+  next_source_hashes.clear();
+}
+}  // namespace yallc
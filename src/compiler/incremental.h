@@ -0,0 +1,50 @@
+#pragma once
+
+#include <llvm/IR/Module.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../import/import.h"
+#include "../logging/logger.h"
+
+namespace yallc {
+
+// Kept between the compilations of --watch. A top level function whose
+// source didn't change reuses its IR from the last compilation instead of
+// being checked and generated again. That's only correct if nothing it
+// depends on changed either, so the errors, classes, declarations, function
+// signatures and inferred error sets form the interface of the program. Any
+// change to it compiles everything again.
+class IncrementalCache {
+ public:
+  // starts a compilation, functions can only be reused if the interface is
+  // the same as last time
+  void begin(size_t interface_hash);
+  // true if the function is taken from the last compilation, its body must
+  // not be generated then
+  bool reuse(const std::string& name, size_t source_hash);
+  // copies the bodies of the reused functions into their declarations, every
+  // function they call has to exist by now
+  void generate_reused(llvm::Module& module);
+  // remembers the module before it's optimized, nothing of a compilation
+  // with errors is kept
+  void finish(const llvm::Module& module, bool failed);
+
+  size_t get_reused_count() const { return reused.size(); }
+
+ private:
+  yalll::Import<util::Logger> logger;
+
+  std::unique_ptr<llvm::Module> snapshot;
+  size_t interface_hash = 0;
+  bool reusable = false;
+
+  // llvm name -> hash of the source of the function
+  std::map<std::string, size_t> source_hashes;
+  std::map<std::string, size_t> next_source_hashes;
+  std::vector<std::string> reused;
+};
+}  // namespace yallc
@@ -0,0 +1,96 @@
+#include "jobs.h"
+
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/Linker/Linker.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/MemoryBufferRef.h>
+#include <llvm/Support/raw_ostream.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "../import/import.h"
+#include "../logging/logger.h"
+
+namespace yallc {
+
+inline size_t token_count(antlr4::ParserRuleContext* ctx) {
+  return ctx->getStop()->getTokenIndex() - ctx->getStart()->getTokenIndex() +
+         1;
+}
+
+std::map<std::string, unsigned> assign_jobs(YALLLParser::ProgramContext* ctx,
+                                            unsigned jobs) {
+  struct Candidate {
+    std::string name;
+    size_t size;
+  };
+  std::vector<Candidate> candidates;
+  std::vector<size_t> loads(jobs, 0);
+  loads.at(0) = token_count(ctx);
+
+  for (auto* definition : ctx->definition()) {
+    auto* function_def = definition->function_def();
+    if (!function_def) continue;
+
+    // multiversioning keeps the function it clones, so it has to stay in the
+    // module of job 0
+    bool multiversion = std::any_of(
+        function_def->annotations.begin(), function_def->annotations.end(),
+        [](YALLLParser::AnnotationContext* annotation) {
+          return annotation->name->getText() == "multiversion";
+        });
+    if (multiversion) continue;
+
+    auto size = token_count(function_def);
+    loads.at(0) -= size;
+    candidates.push_back(Candidate{function_def->func_name->getText(), size});
+  }
+
+  // largest first, always to the job with the least work so far
+  std::stable_sort(candidates.begin(), candidates.end(),
+                   [](const Candidate& lhs, const Candidate& rhs) {
+                     return lhs.size > rhs.size;
+                   });
+  std::map<std::string, unsigned> assigned;
+  for (auto& candidate : candidates) {
+    unsigned job = std::min_element(loads.begin(), loads.end()) - loads.begin();
+    loads.at(job) += candidate.size;
+    assigned.insert(std::pair<std::string, unsigned>(candidate.name, job));
+  }
+
+  yalll::Import<util::Logger> logger;
+  for (unsigned job = 0; job < jobs; ++job) {
+    logger->send_log("Job {} generates {} tokens", job, loads.at(job));
+  }
+  return assigned;
+}
+
+std::string write_fragment(const llvm::Module& fragment) {
+  std::string bitcode;
+  llvm::raw_string_ostream out(bitcode);
+  llvm::WriteBitcodeToFile(fragment, out);
+  out.flush();
+  return bitcode;
+}
+
+bool link_fragment(llvm::Module& module, const std::string& bitcode) {
+  yalll::Import<util::Logger> logger;
+  auto fragment = llvm::parseBitcodeFile(
+      llvm::MemoryBufferRef(bitcode, "fragment"), module.getContext());
+  if (!fragment) {
+    logger->send_internal_error("Can't read a fragment of the jobs: {}",
+                                llvm::toString(fragment.takeError()));
+    return false;
+  }
+
+  // the declarations of the module are replaced by the definitions of the
+  // fragment, types with the same name are merged
+  if (llvm::Linker::linkModules(module, std::move(*fragment))) {
+    logger->send_internal_error("Can't link a fragment of the jobs");
+    return false;
+  }
+  return true;
+}
+}  // namespace yallc
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <llvm/IR/Module.h>
+
+#include <map>
+#include <sstream>
+#include <string>
+
+#include "YALLLParser.h"
+
+namespace yallc {
+
+// --jobs, spreads the top level functions over the jobs by their size in
+// tokens. Job 0 also generates everything that isn't a top level function,
+// i.e. main and the classes, so it starts out with their size. Functions
+// missing from the result belong to job 0.
+std::map<std::string, unsigned> assign_jobs(YALLLParser::ProgramContext* ctx,
+                                            unsigned jobs);
+
+// what a job hands back to job 0, its diagnostics are printed once job 0 is
+// done, so the messages of the jobs don't interleave
+struct Fragment {
+  std::string bitcode;
+  std::ostringstream out;
+  std::ostringstream err;
+  size_t errors = 0;
+};
+
+// every job generates into a module of its own context, modules of different
+// contexts can only be linked by going through bitcode
+std::string write_fragment(const llvm::Module& fragment);
+// false if the fragment couldn't be read or linked
+bool link_fragment(llvm::Module& module, const std::string& bitcode);
+}  // namespace yallc
@@ -0,0 +1,17 @@
+#include "nestinglimit.h"
+
+#include <Exceptions.h>
+#include <Token.h>
+
+namespace yallc {
+
+void NestingLimit::enterEveryRule(antlr4::ParserRuleContext* ctx) {
+  if (++depth <= max_depth) return;
+
+  logger->send_error(
+      "Nesting in line {} is deeper than the {} levels the stack can hold, "
+      "raise --stack-size",
+      ctx->getStart()->getLine(), max_depth);
+  throw antlr4::ParseCancellationException();
+}
+}  // namespace yallc
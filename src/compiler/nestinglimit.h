@@ -0,0 +1,41 @@
+#pragma once
+
+#include <ParserRuleContext.h>
+#include <tree/ErrorNode.h>
+#include <tree/ParseTreeListener.h>
+#include <tree/TerminalNode.h>
+
+#include <cstddef>
+
+#include "../import/import.h"
+#include "../logging/logger.h"
+
+namespace yallc {
+
+// The parser, the visitor and the operations all recurse once per level of
+// the parse tree, nesting deeper than the stack of the compiler thread can
+// hold would crash the compiler. Listens to the parser and cancels parsing
+// with an error once the tree gets too deep for the stack, see
+// design/limits.md.
+class NestingLimit : public antlr4::tree::ParseTreeListener {
+ public:
+  // an estimate of the stack one level of the tree takes in the parser, the
+  // visitor and the code generation together
+  static constexpr size_t STACK_PER_LEVEL = 2048;
+
+  explicit NestingLimit(size_t stack_size)
+      : max_depth(stack_size / STACK_PER_LEVEL) {}
+
+  // throws antlr4::ParseCancellationException beyond the limit
+  void enterEveryRule(antlr4::ParserRuleContext* ctx) override;
+  void exitEveryRule(antlr4::ParserRuleContext* ctx) override { --depth; }
+  void visitTerminal(antlr4::tree::TerminalNode* node) override {}
+  void visitErrorNode(antlr4::tree::ErrorNode* node) override {}
+
+ private:
+  yalll::Import<util::Logger> logger;
+
+  size_t depth = 0;
+  size_t max_depth;
+};
+}  // namespace yallc
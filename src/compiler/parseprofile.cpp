@@ -0,0 +1,61 @@
+#include "parseprofile.h"
+
+#include <atn/DecisionInfo.h>
+#include <atn/DecisionState.h>
+#include <atn/ParseInfo.h>
+
+#include <algorithm>
+#include <format>
+#include <vector>
+
+namespace yallc {
+
+void print_parse_profile(YALLLParser& parser, std::ostream& out) {
+  auto decisions = parser.getParseInfo().getDecisionInfo();
+  // the most expensive decisions first, the ones never taken are omitted
+  std::erase_if(decisions, [](const antlr4::atn::DecisionInfo& info) {
+    return info.invocations == 0;
+  });
+  std::sort(decisions.begin(), decisions.end(),
+            [](const antlr4::atn::DecisionInfo& lhs,
+               const antlr4::atn::DecisionInfo& rhs) {
+              return lhs.timeInPrediction > rhs.timeInPrediction;
+            });
+
+  long long total_time = 0;
+  long long total_fallbacks = 0;
+  for (auto& info : decisions) {
+    total_time += info.timeInPrediction;
+    total_fallbacks += info.LL_Fallback;
+  }
+
+  // SLL is the fast path, LL fallbacks need the full parser context and
+  // ambiguities are resolved by picking the lowest alternative
+  out << std::format(
+             "Parse profile: {} decisions, {} LL fallbacks, {:.3f} ms in "
+             "prediction",
+             decisions.size(), total_fallbacks, total_time / 1e6)
+      << std::endl;
+  out << std::format("{:<22} {:>4} {:>5} {:>10} {:>10} {:>9} {:>8} {:>9} "
+                     "{:>8} {:>6} {:>6}",
+                     "rule", "dec", "alts", "calls", "time[us]", "sll_avg",
+                     "sll_max", "fallbacks", "ll_max", "ambig", "ctxsen")
+      << std::endl;
+
+  auto& atn = parser.getATN();
+  auto& rule_names = parser.getRuleNames();
+  for (auto& info : decisions) {
+    auto* state = atn.getDecisionState(info.decision);
+    out << std::format(
+               "{:<22} {:>4} {:>5} {:>10} {:>10.1f} {:>9.2f} {:>8} {:>9} "
+               "{:>8} {:>6} {:>6}",
+               rule_names.at(state->ruleIndex), info.decision,
+               state->transitions.size(), info.invocations,
+               info.timeInPrediction / 1e3,
+               static_cast<double>(info.SLL_TotalLook) / info.invocations,
+               info.SLL_MaxLook, info.LL_Fallback, info.LL_MaxLook,
+               info.ambiguities.size(), info.contextSensitivities.size())
+        << std::endl;
+  }
+}
+}  // namespace yallc
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <ostream>
+
+#include "YALLLParser.h"
+
+namespace yallc {
+
+// --parse-profile, prints how expensive every decision of the grammar was
+// while parsing. Only works if the parser ran with setProfile(true).
+void print_parse_profile(YALLLParser& parser, std::ostream& out);
+}  // namespace yallc
@@ -0,0 +1,160 @@
+#include "ssabuilder.h"
+
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/ValueHandle.h>
+
+namespace yallc {
+
+SSABuilder::Variable SSABuilder::new_variable(const std::string& name,
+                                              llvm::BasicBlock* block) {
+  variables.emplace_back();
+  variables.back().name = name;
+  variables.back().declared_in = block;
+  return variables.size() - 1;
+}
+
+void SSABuilder::write_variable(Variable variable, llvm::BasicBlock* block,
+                                llvm::Value* value) {
+  variables.at(variable).definitions[block] = value;
+}
+
+llvm::Value* SSABuilder::read_variable(Variable variable, llvm::Type* type,
+                                       llvm::BasicBlock* block) {
+  auto& definitions = variables.at(variable).definitions;
+  if (auto it = definitions.find(block); it != definitions.end())
+    return it->second;
+  return read_variable_recursive(variable, type, block);
+}
+
+void SSABuilder::mark_assigned(Variable variable, llvm::BasicBlock* block) {
+  variables.at(variable).assigned_in.insert(block);
+}
+
+bool SSABuilder::may_be_assigned(Variable variable,
+                                 llvm::BasicBlock* block) const {
+  auto& data = variables.at(variable);
+  if (data.assigned_in.empty()) return false;
+
+  // walks the paths to the block backwards until they hit an assignment or
+  // the declaration, a variable declared in a loop is a new one every
+  // iteration
+  llvm::DenseSet<llvm::BasicBlock*> visited{block};
+  std::vector<llvm::BasicBlock*> todo{block};
+  while (!todo.empty()) {
+    auto* current = todo.back();
+    todo.pop_back();
+    if (data.assigned_in.contains(current)) return true;
+    if (current == data.declared_in) continue;
+    for (auto* predecessor : llvm::predecessors(current)) {
+      if (visited.insert(predecessor).second) todo.push_back(predecessor);
+    }
+  }
+  return false;
+}
+
+void SSABuilder::open_block(llvm::BasicBlock* block) {
+  open_blocks.insert(block);
+}
+
+void SSABuilder::seal_block(llvm::BasicBlock* block) {
+  open_blocks.erase(block);
+  auto it = incomplete_phis.find(block);
+  if (it == incomplete_phis.end()) return;
+
+  // adding operands may read through this block again
+  auto phis = std::move(it->second);
+  incomplete_phis.erase(it);
+  for (auto& [variable, phi] : phis) {
+    (void)add_phi_operands(variable, phi);
+  }
+}
+
+llvm::Value* SSABuilder::read_variable_recursive(Variable variable,
+                                                 llvm::Type* type,
+                                                 llvm::BasicBlock* block) {
+  llvm::Value* value;
+  if (open_blocks.contains(block)) {
+    // not every predecessor is known yet, the phi is completed on sealing
+    auto* phi = create_phi(variable, type, block);
+    incomplete_phis[block].push_back(
+        std::pair<Variable, llvm::PHINode*>(variable, phi));
+    value = phi;
+  } else if (auto* predecessor = block->getSinglePredecessor()) {
+    value = read_variable(variable, type, predecessor);
+  } else if (llvm::pred_empty(block)) {
+    // read before any assignment
+    value = llvm::PoisonValue::get(type);
+  } else {
+    // the phi breaks cycles through the predecessors
+    auto* phi = create_phi(variable, type, block);
+    write_variable(variable, block, phi);
+    value = add_phi_operands(variable, phi);
+  }
+  write_variable(variable, block, value);
+  return value;
+}
+
+llvm::PHINode* SSABuilder::create_phi(Variable variable, llvm::Type* type,
+                                      llvm::BasicBlock* block) {
+  auto& name = variables.at(variable).name;
+  // phis always come first, the block may already hold instructions
+  auto* phi = block->empty()
+                  ? llvm::PHINode::Create(type, 2, name, block)
+                  : llvm::PHINode::Create(type, 2, name, &block->front());
+  phi_variables[phi] = variable;
+  logger->send_log("Placed phi for {} in {}", name, block->getName().str());
+  return phi;
+}
+
+llvm::Value* SSABuilder::add_phi_operands(Variable variable,
+                                          llvm::PHINode* phi) {
+  // a predecessor with several edges to the block needs an entry per edge
+  for (auto* predecessor : llvm::predecessors(phi->getParent())) {
+    phi->addIncoming(read_variable(variable, phi->getType(), predecessor),
+                     predecessor);
+  }
+  return try_remove_trivial_phi(phi);
+}
+
+llvm::Value* SSABuilder::try_remove_trivial_phi(llvm::PHINode* phi) {
+  llvm::Value* same = nullptr;
+  for (auto& operand : phi->incoming_values()) {
+    if (operand == same || operand == phi) continue;
+    // merges at least two values
+    if (same) return phi;
+    same = operand;
+  }
+  // unreachable or only reached by itself
+  if (!same) same = llvm::PoisonValue::get(phi->getType());
+
+  // phis using this one may become trivial as well, they can be removed
+  // while we recurse
+  std::vector<llvm::WeakVH> users;
+  for (auto* user : phi->users()) {
+    if (user != phi && llvm::isa<llvm::PHINode>(user))
+      users.emplace_back(user);
+  }
+
+  phi_variables.erase(phi);
+  phi->replaceAllUsesWith(same);
+  phi->eraseFromParent();
+
+  for (auto& user : users) {
+    auto* user_phi = llvm::dyn_cast_or_null<llvm::PHINode>(user);
+    // only complete phis of variables can be removed
+    if (user_phi && phi_variables.count(user_phi) &&
+        !open_blocks.contains(user_phi->getParent())) {
+      (void)try_remove_trivial_phi(user_phi);
+    }
+  }
+  return same;
+}
+
+void SSABuilder::clear() {
+  variables.assign(1, VariableData());
+  phi_variables.clear();
+  incomplete_phis.clear();
+  open_blocks.clear();
+}
+}  // namespace yallc
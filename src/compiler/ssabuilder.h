@@ -0,0 +1,84 @@
+#pragma once
+
+#include <llvm/ADT/DenseMap.h>
+#include <llvm/ADT/DenseSet.h>
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Type.h>
+#include <llvm/IR/Value.h>
+#include <llvm/IR/ValueHandle.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../import/import.h"
+#include "../logging/logger.h"
+
+namespace yallc {
+
+// Builds SSA form for mutable variables while the code is generated, after
+// Braun et al. "Simple and Efficient Construction of Static Single Assignment
+// Form". Every block knows the last value written to a variable, a read in a
+// block without one looks through the predecessors and places phis where
+// different values meet. Trivial phis are removed right away, so the IR is
+// already minimal and doesn't need mem2reg.
+// Blocks that get predecessors later (loop headers) have to be opened before
+// the first read and sealed once the last branch to them exists. Every other
+// block is assumed to have all of its predecessors when it's read from.
+class SSABuilder {
+ public:
+  using Variable = size_t;
+  // 0 is never a variable, values that aren't tracked keep it
+  static constexpr Variable NO_VARIABLE = 0;
+
+  // a variable only exists from its declaration in block onwards
+  Variable new_variable(const std::string& name, llvm::BasicBlock* block);
+
+  void write_variable(Variable variable, llvm::BasicBlock* block,
+                      llvm::Value* value);
+  // poison if the variable isn't assigned on any path to the block
+  llvm::Value* read_variable(Variable variable, llvm::Type* type,
+                             llvm::BasicBlock* block);
+  // assignments are tracked apart from the values, the initial value of a
+  // declared variable isn't one
+  void mark_assigned(Variable variable, llvm::BasicBlock* block);
+  // false if no path to the end of the block assigns the variable so far.
+  // Only looks at the predecessors known yet and never places phis.
+  bool may_be_assigned(Variable variable, llvm::BasicBlock* block) const;
+
+  void open_block(llvm::BasicBlock* block);
+  void seal_block(llvm::BasicBlock* block);
+
+  // forgets every variable once a function is generated, nothing refers to
+  // them afterwards
+  void clear();
+
+ private:
+  yalll::Import<util::Logger> logger;
+
+  struct VariableData {
+    std::string name;
+    // any variable can hold a phi of another one, removing a trivial phi
+    // updates them all
+    llvm::DenseMap<llvm::BasicBlock*, llvm::WeakTrackingVH> definitions;
+    llvm::DenseSet<llvm::BasicBlock*> assigned_in;
+    llvm::BasicBlock* declared_in = nullptr;
+  };
+
+  llvm::Value* read_variable_recursive(Variable variable, llvm::Type* type,
+                                       llvm::BasicBlock* block);
+  llvm::PHINode* create_phi(Variable variable, llvm::Type* type,
+                            llvm::BasicBlock* block);
+  llvm::Value* add_phi_operands(Variable variable, llvm::PHINode* phi);
+  llvm::Value* try_remove_trivial_phi(llvm::PHINode* phi);
+
+  // index 0 is NO_VARIABLE
+  std::vector<VariableData> variables{VariableData()};
+  llvm::DenseMap<llvm::PHINode*, Variable> phi_variables;
+  llvm::DenseMap<llvm::BasicBlock*,
+                 std::vector<std::pair<Variable, llvm::PHINode*>>>
+      incomplete_phis;
+  llvm::DenseSet<llvm::BasicBlock*> open_blocks;
+};
+}  // namespace yallc
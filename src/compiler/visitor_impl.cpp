@@ -4,38 +4,64 @@
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/ExecutionEngine/GenericValue.h>
 #include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/CFG.h>
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/InstrTypes.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/MDBuilder.h>
 #include <llvm/IR/Value.h>
 #include <llvm/Support/raw_ostream.h>
+#include <llvm/Support/thread.h>
 #include <llvm/Target/TargetOptions.h>
 #include <tree/ParseTree.h>
 #include <tree/ParseTreeType.h>
 #include <tree/ParseTreeWalker.h>
 
+#include <algorithm>
 #include <any>
+#include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <format>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <optional>
 #include <ostream>
 #include <source_location>
+#include <sstream>
 #include <string>
 #include <typeinfo>
 #include <vector>
 
+#include "../builtin/builtins.h"
+#include "../class/class.h"
 #include "../function/function.h"
 #include "../operation/addoperation.h"
 #include "../operation/andoperation.h"
 #include "../operation/cmpoperation.h"
 #include "../operation/funccalloperation.h"
+#include "../operation/intrinsicoperation.h"
+#include "../operation/iserroperation.h"
 #include "../operation/muloperation.h"
+#include "../operation/newoperation.h"
+#include "../operation/onerroperation.h"
 #include "../operation/operation.h"
 #include "../operation/oroperation.h"
+#include "../operation/reterroperation.h"
 #include "../operation/terminaloperation.h"
+#include "../operation/vectoroperation.h"
+#include "../optimizer/optimizer.h"
 #include "../scoping/scope.h"
 #include "../value/value.h"
 #include "YALLLParser.h"
+#include "compilationcontext.h"
+#include "compileroptions.h"
+#include "fastmath.h"
+#include "jobs.h"
 
 namespace yallc {
 
@@ -94,6 +120,19 @@ inline std::shared_ptr<yalll::Operation> to_operation(
       return std::any_cast<std::shared_ptr<yalll::TerminalOperation>>(any);
     if (type == typeid(std::shared_ptr<yalll::FuncCallOperation>).hash_code())
       return std::any_cast<std::shared_ptr<yalll::FuncCallOperation>>(any);
+    if (type == typeid(std::shared_ptr<yalll::NewOperation>).hash_code())
+      return std::any_cast<std::shared_ptr<yalll::NewOperation>>(any);
+    if (type ==
+        typeid(std::shared_ptr<yalll::IntrinsicOperation>).hash_code())
+      return std::any_cast<std::shared_ptr<yalll::IntrinsicOperation>>(any);
+    if (type == typeid(std::shared_ptr<yalll::ReterrOperation>).hash_code())
+      return std::any_cast<std::shared_ptr<yalll::ReterrOperation>>(any);
+    if (type == typeid(std::shared_ptr<yalll::IserrOperation>).hash_code())
+      return std::any_cast<std::shared_ptr<yalll::IserrOperation>>(any);
+    if (type == typeid(std::shared_ptr<yalll::OnerrOperation>).hash_code())
+      return std::any_cast<std::shared_ptr<yalll::OnerrOperation>>(any);
+    if (type == typeid(std::shared_ptr<yalll::VectorOperation>).hash_code())
+      return std::any_cast<std::shared_ptr<yalll::VectorOperation>>(any);
 
     return std::any_cast<std::shared_ptr<yalll::Operation>>(any);
   } catch (const std::bad_any_cast& cast) {
@@ -106,39 +145,504 @@ inline std::shared_ptr<yalll::Operation> to_operation(
   }
 }
 
-YALLLVisitorImpl::YALLLVisitorImpl(std::string out_path) : out_path(out_path) {
+// [1k] -> 1024 bytes
+inline uint64_t size_in_bytes(YALLLParser::SizeContext* ctx) {
+  yalll::Import<util::Logger> logger;
+  auto digits = ctx->val->getText();
+  uint64_t size = 0;
+  auto [ptr, ec] =
+      std::from_chars(digits.data(), digits.data() + digits.size(), size);
+  if (ec == std::errc::result_out_of_range) {
+    logger->send_error("Size {} in line {} is too large", digits,
+                       ctx->val->getLine());
+    return 0;
+  }
+  if (!ctx->unit) return size;
+
+  auto unit = ctx->unit->getText();
+  uint64_t factor = 1;
+  if (unit == "k") {
+    factor = 1024;
+  } else if (unit == "m") {
+    factor = 1024 * 1024;
+  } else {
+    logger->send_error("Unknown size unit {} in line {}", unit,
+                       ctx->unit->getLine());
+    return size;
+  }
+  if (size > UINT64_MAX / factor) {
+    logger->send_error("Size {}{} in line {} is too large", digits, unit,
+                       ctx->val->getLine());
+    return 0;
+  }
+  return size * factor;
+}
+
+// allocations inside of loops can't be bounded at compile time
+inline bool inside_loop(antlr4::tree::ParseTree* node) {
+  for (; node; node = node->parent) {
+    if (dynamic_cast<YALLLParser::LoopContext*>(node)) return true;
+    if (dynamic_cast<YALLLParser::Function_defContext*>(node)) return false;
+  }
+  return false;
+}
+
+// return f(...), the call is the whole returned value
+inline bool is_returned(antlr4::tree::ParseTree* node) {
+  for (auto* parent = node->parent; parent;
+       node = parent, parent = parent->parent) {
+    if (auto* expression =
+            dynamic_cast<YALLLParser::ExpressionContext*>(parent)) {
+      return expression->getStart()->getType() == YALLLParser::RETURN_KW &&
+             expression->ret_val == node;
+    }
+    if (parent->children.size() != 1) return false;
+  }
+  return false;
+}
+
+// likely / unlikely or a condition of expect(cmp, true / false) as weights
+// of the branch taken on true and false
+inline llvm::MDNode* branch_weights(YALLLParser::Branch_hintContext* hint,
+                                    llvm::Value* condition) {
+  std::optional<bool> likely;
+  if (hint) {
+    likely = hint->LIKELY_KW() != nullptr;
+  } else if (auto* expect = llvm::dyn_cast<llvm::IntrinsicInst>(condition);
+             expect && expect->getIntrinsicID() == llvm::Intrinsic::expect) {
+    if (auto* expected =
+            llvm::dyn_cast<llvm::ConstantInt>(expect->getArgOperand(1))) {
+      likely = expected->isOne();
+    }
+  }
+  if (!likely) return nullptr;
+
+  llvm::MDBuilder md_builder(condition->getContext());
+  return *likely ? md_builder.createBranchWeights(2000, 1)
+                 : md_builder.createBranchWeights(1, 2000);
+}
+
+// the source from start up to stop, with or without stop itself
+inline std::string source_text(antlr4::Token* start, antlr4::Token* stop,
+                               bool including_stop = false) {
+  auto stop_index = including_stop ? stop->getStopIndex()
+                                   : stop->getStartIndex() - 1;
+  return start->getInputStream()->getText(
+      antlr4::misc::Interval(start->getStartIndex(), stop_index));
+}
+
+// tailcc isn't the C convention, a recursive function visible outside of the
+// module keeps its body internal and is called through a C wrapper
+inline void wrap_tail_functions(llvm::Module& module) {
+  std::vector<llvm::Function*> functions;
+  for (auto& function : module) {
+    if (function.getCallingConv() == llvm::CallingConv::Tail &&
+        !function.isDeclaration() && !function.hasLocalLinkage()) {
+      functions.push_back(&function);
+    }
+  }
+
+  for (auto* function : functions) {
+    auto name = function->getName().str();
+    auto linkage = function->getLinkage();
+    function->setName(name + ".tailcc");
+    function->setLinkage(llvm::GlobalValue::InternalLinkage);
+
+    auto* wrapper = llvm::Function::Create(function->getFunctionType(),
+                                           linkage, name, module);
+    wrapper->copyAttributesFrom(function);
+    wrapper->setCallingConv(llvm::CallingConv::C);
+    llvm::IRBuilder<> wrapper_builder(
+        llvm::BasicBlock::Create(module.getContext(), "entry", wrapper));
+    std::vector<llvm::Value*> arguments;
+    for (auto& arg : wrapper->args()) {
+      arguments.push_back(&arg);
+    }
+    auto* call = wrapper_builder.CreateCall(function, arguments);
+    call->setCallingConv(llvm::CallingConv::Tail);
+    call->setTailCallKind(llvm::CallInst::TCK_Tail);
+    if (call->getType()->isVoidTy())
+      wrapper_builder.CreateRetVoid();
+    else
+      wrapper_builder.CreateRet(call);
+  }
+}
+
+// a block that already returned must not get a second terminator
+inline void branch_if_open(llvm::BasicBlock* target) {
+  yalll::Import<llvm::IRBuilder<>> builder;
+  if (!builder->GetInsertBlock()->getTerminator()) builder->CreateBr(target);
+}
+
+YALLLVisitorImpl::YALLLVisitorImpl(std::string out_path,
+                                   std::string source_path,
+                                   IncrementalCache* cache)
+    : cache(cache), out_path(out_path) {
   yalll::Import<llvm::LLVMContext> context;
   module = std::make_unique<llvm::Module>("YALLL", *context);
+  module->setSourceFileName(source_path);
+  if (target.initialize()) target.configure(*module);
+
+  // --fast-math applies everywhere, @fastmath adds to it
+  yalll::Import<CompilerOptions> options;
+  llvm::FastMathFlags fast_math;
+  std::stringstream flags(options->fast_math);
+  std::string flag;
+  while (std::getline(flags, flag, ',')) {
+    if (!add_fast_math_flag(fast_math, flag))
+      logger->send_error("Unknown fast math flag {}", flag);
+  }
+  builder->setFastMathFlags(fast_math);
+
+  if (options->debug_info) {
+    debug_info = std::make_unique<yalll::DebugInfo>(*module, source_path,
+                                                    options->opt_level > 0);
+  }
 }
 
-YALLLVisitorImpl::~YALLLVisitorImpl() {}
+YALLLVisitorImpl::~YALLLVisitorImpl() {
+  // the builder outlives the module, --watch compiles again with it
+  builder->ClearInsertionPoint();
+}
 
 std::any YALLLVisitorImpl::visitProgram(YALLLParser::ProgramContext* ctx) {
+  prepare(ctx);
+  elut.generate(*module);
+
+  // debug info of reused functions would point to the last compilation
+  yalll::Import<CompilerOptions> options;
+  if (debug_info) cache = nullptr;
+  auto errors_before = logger->get_error_count();
+  if (cache) cache->begin(interface_hash(ctx));
+
+  // the other jobs visit the same tree, each on a thread with a compilation
+  // context of its own, this one is job 0. Debug info and --watch need every
+  // function in this module.
+  std::map<std::string, unsigned> jobs;
+  std::vector<Fragment> fragments(options->jobs);
+  std::vector<llvm::thread> workers;
+  CompilerOptions job_options = *options;
+  if (options->jobs > 1 && !debug_info && !cache) {
+    jobs = assign_jobs(ctx, options->jobs);
+    job_of = &jobs;
+    auto source_path = module->getSourceFileName();
+    for (unsigned worker_job = 1; worker_job < options->jobs; ++worker_job) {
+      workers.emplace_back(options->stack_size, [&, worker_job]() {
+        auto& fragment = fragments.at(worker_job);
+        CompilationContext job_context(job_options, fragment.out,
+                                       fragment.err);
+        CompilationContext::Activation activation(job_context);
+        // job 0 reports everything but the bodies of the other jobs
+        job_context.logger.set_muted(true);
+
+        YALLLVisitorImpl worker("", source_path);
+        fragment.bitcode = worker.generate_fragment(ctx, jobs, worker_job);
+        fragment.errors = job_context.logger.get_error_count();
+      });
+    }
+  }
+
   auto res = visitChildren(ctx);
 
+  for (auto& worker : workers) {
+    worker.join();
+  }
+  for (auto& fragment : fragments) {
+    logger->get_out() << fragment.out.str();
+    logger->get_err() << fragment.err.str();
+    logger->add_errors(fragment.errors);
+    if (!fragment.bitcode.empty())
+      (void)link_fragment(*module, fragment.bitcode);
+  }
+
+  if (cache) {
+    cache->generate_reused(*module);
+    cache->finish(*module, logger->get_error_count() > errors_before);
+  }
+
+  finish_module();
+  return res;
+}
+
+std::string YALLLVisitorImpl::generate_fragment(
+    YALLLParser::ProgramContext* ctx,
+    const std::map<std::string, unsigned>& job_of, unsigned job) {
+  logger->send_log("Generating job {}", job);
+  ++*logger;
+  this->job_of = &job_of;
+  this->job = job;
+
+  // the ELUT only ends up in the module of job 0
+  prepare(ctx);
+  visitChildren(ctx);
+
+  --*logger;
+  return write_fragment(*module);
+}
+
+void YALLLVisitorImpl::begin_stream() {
+  logger->send_log("Streaming the program");
+  // without the whole program there is no call graph, only explicit noerr
+  // functions are noerr and every call of the others can return any error
+  cache = nullptr;
+}
+
+void YALLLVisitorImpl::visit_top_level(YALLLParser::Top_levelContext* ctx) {
+  // only the errors defined up to here are known
+  if (auto* definition = ctx->definition()) {
+    if (auto* error_def = definition->error_def())
+      register_error(error_def, "");
+  } else if (auto* klass = ctx->class_()) {
+    for (auto* error_block : klass->body->error_block()) {
+      for (auto* error_def : error_block->errors) {
+        register_error(error_def, klass->name->getText() + "::");
+      }
+    }
+  } else if (ctx->entry_point() && module->getFunction("main")) {
+    logger->send_error("Second entry point in line {}",
+                       ctx->getStart()->getLine());
+    return;
+  }
+
+  visitChildren(ctx);
+}
+
+void YALLLVisitorImpl::end_stream() {
+  // nothing refers to the table itself, so it can be generated last
+  elut.generate(*module);
+  finish_module();
+}
+
+void YALLLVisitorImpl::finish_module() {
+  yalll::Import<CompilerOptions> options;
+  if (debug_info) debug_info->finalize();
+  wrap_tail_functions(*module);
+  target.annotate(*module);
+  multiversioning.generate(*module, target);
+  if (options->infer_effects) {
+    analysis::EffectAnalysis effects(!options->profile_generate);
+    effects.run(*module);
+  }
+  if (options->frame_pointer) {
+    for (auto& function : *module) {
+      function.addFnAttr("frame-pointer", "all");
+    }
+  }
+
+  Optimizer optimizer(target.get_machine());
+  if (options->whole_program) optimizer.internalize(*module, exported);
+  (void)optimizer.optimize(*module);
+
   std::error_code ec;
   llvm::raw_fd_ostream llvm_out(out_path, ec);
   module->print(llvm_out, nullptr);
+}
 
-  return res;
+void YALLLVisitorImpl::prepare(YALLLParser::ProgramContext* ctx) {
+  // errors can be used before they are defined, so the ELUT has to be
+  // complete before any code is generated
+  collect_errors(ctx);
+
+  // functions can only be compiled as noerr, if all of their callees are
+  // known upfront
+  yalll::Import<CompilerOptions> options;
+  callgraph.build(ctx, [this](const std::string& name,
+                              const std::string& owner) -> std::string {
+    if (!owner.empty() && elut.contains(owner + "::" + name))
+      return owner + "::" + name;
+    return elut.contains(name) ? name : "";
+  });
+  callgraph.infer_noerr(options->infer_noerr);
+  if (options->reachable_only) collect_reachable();
+
+  declare_signatures(ctx);
 }
 
-std::any YALLLVisitorImpl::visitInterface(YALLLParser::InterfaceContext* ctx) {
+void YALLLVisitorImpl::collect_errors(YALLLParser::ProgramContext* ctx) {
+  logger->send_log("Collecting errors");
   ++*logger;
-  auto res = visitChildren(ctx);
+
+  for (auto* definition : ctx->definition()) {
+    if (auto* error_def = definition->error_def()) {
+      register_error(error_def, "");
+    }
+  }
+
+  // errors of a class are qualified with its name, i.e. Foo::error_a
+  for (auto* klass : ctx->class_()) {
+    for (auto* error_block : klass->body->error_block()) {
+      for (auto* error_def : error_block->errors) {
+        register_error(error_def, klass->name->getText() + "::");
+      }
+    }
+  }
+
   --*logger;
-  return res;
+}
+
+void YALLLVisitorImpl::register_error(YALLLParser::Error_defContext* error_def,
+                                      const std::string& prefix) {
+  auto message = error_def->message->getText();
+  elut.register_error(prefix + error_def->name->getText(),
+                      message.substr(1, message.size() - 2),
+                      error_def->name->getLine());
+}
+
+void YALLLVisitorImpl::declare_signatures(YALLLParser::ProgramContext* ctx) {
+  logger->send_log("Declaring signatures");
+  ++*logger;
+
+  // a top level function can be called anywhere in the program, not only
+  // after its definition
+  for (auto* declaration : ctx->declaration()) {
+    if (auto* function_dec = declaration->function_dec()) visit(function_dec);
+  }
+  for (auto* definition : ctx->definition()) {
+    if (auto* function_def = definition->function_def())
+      declare_signature(function_def);
+  }
+
+  --*logger;
+}
+
+void YALLLVisitorImpl::declare_signature(
+    YALLLParser::Function_defContext* function_def) {
+  auto name = function_def->func_name->getText();
+  auto* owner = cur_scope.get_active_class();
+  auto owner_name = owner ? owner->get_name() : "";
+  if (reachable &&
+      !reachable->contains(owner ? owner_name + "." + name : name)) {
+    return;
+  }
+  // an explicit declaration is checked against the definition later on
+  auto* declared = cur_scope.lookup_function(name);
+  if (declared && declared->get_owner() == owner_name) return;
+
+  auto ret_type =
+      typesafety::TypeInformation::from_context_node(function_def->ret_type);
+  auto params =
+      std::any_cast<std::vector<yalll::Value>>(visit(function_def->parm_list));
+  (void)declare_function(name, ret_type, params, function_def->NOERR_KW(),
+                         false);
+}
+
+bool YALLLVisitorImpl::generates(const std::string& llvm_name) const {
+  if (!job_of) return true;
+  auto it = job_of->find(llvm_name);
+  return (it == job_of->end() ? 0 : it->second) == job;
+}
+
+void YALLLVisitorImpl::collect_reachable() {
+  // methods can only be called by other methods of their class for now, so
+  // they are kept together with their class
+  std::vector<std::string> roots{"main"};
+  for (auto& [name, node] : callgraph.get_nodes()) {
+    if (node.exported || name.contains('.')) roots.push_back(name);
+  }
+  reachable = callgraph.reachable(roots);
+
+  for (auto& [name, node] : callgraph.get_nodes()) {
+    if (!node.declared_only && !reachable->contains(name))
+      logger->send_log("{} in line {} is unreachable, skipping it", name,
+                       node.line);
+  }
+}
+
+size_t YALLLVisitorImpl::interface_hash(YALLLParser::ProgramContext* ctx) {
+  // everything a function can depend on, except the bodies of the other
+  // functions
+  std::string interface;
+  for (auto* child : ctx->children) {
+    auto* rule = dynamic_cast<antlr4::ParserRuleContext*>(child);
+    if (!rule || dynamic_cast<YALLLParser::Entry_pointContext*>(rule))
+      continue;
+
+    auto* definition = dynamic_cast<YALLLParser::DefinitionContext*>(rule);
+    if (definition && definition->function_def()) {
+      auto* function_def = definition->function_def();
+      interface += source_text(function_def->getStart(),
+                               function_def->func_block->getStart());
+    } else {
+      interface += source_text(rule->getStart(), rule->getStop(), true);
+    }
+    interface += "\n";
+  }
+
+  for (auto& [name, node] : callgraph.get_nodes()) {
+    interface += std::format("{} {} {} {}\n", name, node.noerr,
+                             node.recursive, node.errors.to_string());
+  }
+  return std::hash<std::string>()(interface);
+}
+
+std::string YALLLVisitorImpl::resolve_error_name(const std::string& name) {
+  // errors of the active class shadow global errors
+  if (auto* klass = cur_scope.get_active_class()) {
+    auto qualified = klass->get_name() + "::" + name;
+    if (elut.contains(qualified)) return qualified;
+  }
+  return elut.contains(name) ? name : "";
+}
+
+std::any YALLLVisitorImpl::visitInterface(YALLLParser::InterfaceContext* ctx) {
+  // the declarations of an interface don't declare functions themselves
+  logger->send_log("Visiting interface {}", ctx->NAME()->getText());
+  return std::any();
 }
 
 std::any YALLLVisitorImpl::visitClass(YALLLParser::ClassContext* ctx) {
+  std::string name = ctx->name->getText();
+  logger->send_log("Visiting class {}", name);
   ++*logger;
-  auto res = visitChildren(ctx);
+
+  yalll::Class klass(name, ctx->mem_size ? size_in_bytes(ctx->mem_size) : 0);
+  for (auto* pp_block : ctx->body->pp_block()) {
+    for (auto* declaration : pp_block->declaration()) {
+      if (auto* var_dec = declaration->var_dec()) {
+        klass.add_field(yalll::Value(
+            typesafety::TypeInformation::from_context_node(var_dec->ty),
+            nullptr, var_dec->getStart()->getLine(),
+            var_dec->name->getText()));
+      }
+    }
+  }
+
+  klass.generate_type(*module);
+  klass.generate_object_memory(*module);
+  cur_scope.add_class(name, std::move(klass));
+  cur_scope.set_active_class(name);
+
+  cur_scope.push(name);
+  for (auto* pp_block : ctx->body->pp_block()) {
+    for (auto* declaration : pp_block->declaration()) {
+      if (auto* function_dec = declaration->function_dec()) {
+        visit(function_dec);
+      }
+    }
+  }
+  // like top level functions, a method can call the methods defined after it
+  for (auto* pp_block : ctx->body->pp_block()) {
+    for (auto* function_def : pp_block->function_def()) {
+      declare_signature(function_def);
+    }
+  }
+  for (auto* pp_block : ctx->body->pp_block()) {
+    for (auto* function_def : pp_block->function_def()) {
+      visit(function_def);
+    }
+  }
+  cur_scope.pop();
+
+  cur_scope.get_active_class()->check_object_memory_bound();
+  cur_scope.no_active_class();
+
   --*logger;
-  return res;
+  return std::any();
 }
 
 std::any YALLLVisitorImpl::visitEntry_point(
     YALLLParser::Entry_pointContext* ctx) {
+  if (!generates("main")) return std::any();
   logger->send_log("Entering main function");
   ++*logger;
 
@@ -148,11 +652,19 @@ std::any YALLLVisitorImpl::visitEntry_point(
   (void)func.generate_function_sig(*module);
   cur_scope.add_function("main", std::move(func));
   cur_scope.set_active_function("main");
+  if (debug_info) {
+    debug_info->begin_function(cur_scope.get_active_function()->llvm_func,
+                               "main", ctx->getStart()->getLine());
+  }
 
   visitChildren(ctx);
 
   // ensure error exit if no return given by program
-  builder->CreateRet(llvm::ConstantInt::getSigned(builder->getInt32Ty(), 1));
+  if (!builder->GetInsertBlock()->getTerminator())
+    builder->CreateRet(llvm::ConstantInt::getSigned(builder->getInt32Ty(), 1));
+  if (debug_info) debug_info->end_function();
+  ssa.clear();
+  loop_depth_of.clear();
 
   --*logger;
   return std::any();
@@ -169,6 +681,20 @@ std::any YALLLVisitorImpl::visitExpression(
   ++*logger;
 
   switch (ctx->getStart()->getType()) {
+    case YALLLParser::BREAK_KW:
+    case YALLLParser::CONTINUE_KW: {
+      bool is_break = ctx->getStart()->getType() == YALLLParser::BREAK_KW;
+      if (loops.empty()) {
+        logger->send_error("{} outside of a loop in line {}",
+                           ctx->getStart()->getText(),
+                           ctx->getStart()->getLine());
+      } else {
+        builder->CreateBr(is_break ? loops.back().exit : loops.back().next);
+      }
+      --*logger;
+      return std::any();
+    }
+
     case YALLLParser::RETURN_KW:
       logger->send_log<std::string>("Returning {}", ctx->ret_val->getText());
 
@@ -176,6 +702,24 @@ std::any YALLLVisitorImpl::visitExpression(
       if (cur_scope.has_active_function() &&
           operation->resolve_with_type_info(
               cur_scope.get_active_function()->get_return_type())) {
+        // return f(...) reuses the stack frame if possible
+        auto call =
+            std::dynamic_pointer_cast<yalll::FuncCallOperation>(operation);
+        if (call) {
+          auto reason =
+              call->generate_tail_call(*cur_scope.get_active_function());
+          if (reason.empty()) {
+            --*logger;
+            return std::any();
+          }
+          if (call->is_tail_call_required()) {
+            logger->send_error(
+                "Can't make call to {} in line {} a tail call, {}",
+                call->get_function().get_name(), ctx->getStart()->getLine(),
+                reason);
+          }
+        }
+
         cur_scope.get_active_function()->ret_val = operation->generate_value();
         logger->send_log("Return Info: {}",
                          cur_scope.get_active_function()->ret_val.to_string());
@@ -190,6 +734,16 @@ std::any YALLLVisitorImpl::visitExpression(
       return std::any();
   }
 
+  // f(); or reterr error; only exist for their side effects
+  if (auto* operation_ctx = ctx->operation()) {
+    auto operation = to_operation(visit(operation_ctx));
+    if (operation->resolve_without_type_info())
+      (void)operation->generate_value();
+
+    --*logger;
+    return std::any();
+  }
+
   --*logger;
   return visitChildren(ctx);
 }
@@ -199,16 +753,34 @@ std::any YALLLVisitorImpl::visitBlock(YALLLParser::BlockContext* ctx) {
   ++*logger;
 
   cur_scope.push();
-  for (auto* statement : ctx->statements) {
-    logger->send_log("Statement: {}", statement->getText());
-    visit(statement);
-  }
-
+  visit_statements(ctx->statements);
   cur_scope.pop();
+
   --*logger;
   return std::any();
 }
 
+void YALLLVisitorImpl::visit_statements(
+    const std::vector<YALLLParser::StatementContext*>& statements) {
+  for (auto* statement : statements) {
+    // everything after a return is dead and would follow a terminator
+    if (builder->GetInsertBlock()->getTerminator()) {
+      logger->send_warning("Unreachable statement in line {}",
+                           statement->getStart()->getLine());
+      break;
+    }
+    // the text of a statement contains every nested statement, logging it
+    // would be quadratic in the nesting depth
+    logger->send_log("Statement in line {}", statement->getStart()->getLine());
+    if (debug_info) {
+      debug_info->set_location(
+          statement->getStart()->getLine(),
+          statement->getStart()->getCharPositionInLine() + 1);
+    }
+    visit(statement);
+  }
+}
+
 std::any YALLLVisitorImpl::visitAssignment(
     YALLLParser::AssignmentContext* ctx) {
   logger->send_log("Visiting assignment");
@@ -216,16 +788,41 @@ std::any YALLLVisitorImpl::visitAssignment(
   auto* variable = cur_scope.find_field(ctx->name->getText());
 
   if (variable) {
-    if (!variable->type_info.is_mutable() && variable->llvm_val) {
-      logger->send_error("Trying to reassign immutable value {} in line {}",
-                         ctx->name->getText(), ctx->name->getLine());
-      --*logger;
-      return std::any();
+    // a declared immutable variable may be assigned once on every path
+    if (!variable->type_info.is_mutable()) {
+      bool assigned = variable->ssa_variable
+                          ? ssa.may_be_assigned(variable->ssa_variable,
+                                                builder->GetInsertBlock())
+                          : variable->llvm_val != nullptr;
+      if (assigned) {
+        logger->send_error("Trying to reassign immutable value {} in line {}",
+                           ctx->name->getText(), ctx->name->getLine());
+        --*logger;
+        return std::any();
+      }
+      // only loops entered after the declaration repeat the assignment of
+      // the same variable
+      if (variable->ssa_variable) {
+        for (auto i = loop_depth_of.at(variable->ssa_variable);
+             i < loops.size(); ++i) {
+          loop_assignments.push_back(
+              LoopAssignment{variable->ssa_variable, ctx->name->getText(),
+                             ctx->name->getLine(), loops.at(i).exit});
+        }
+      }
     }
 
     auto operation = to_operation(visit(ctx->val));
     if (operation->resolve_with_type_info(variable->type_info)) {
-      variable->llvm_val = operation->generate_value().get_llvm_val();
+      auto* value = operation->generate_value().get_llvm_val();
+      // the value may have been generated in a different block
+      if (variable->ssa_variable) {
+        ssa.write_variable(variable->ssa_variable, builder->GetInsertBlock(),
+                           value);
+        ssa.mark_assigned(variable->ssa_variable, builder->GetInsertBlock());
+      } else {
+        variable->llvm_val = value;
+      }
     }
   } else {
     logger->send_error("Undeclared variable {} used in line {}",
@@ -236,6 +833,33 @@ std::any YALLLVisitorImpl::visitAssignment(
   return std::any();
 }
 
+void YALLLVisitorImpl::track_variable(yalll::Value& variable,
+                                      llvm::Value* initial) {
+  // variables outside of functions have no blocks to be tracked in
+  if (!cur_scope.has_active_function()) return;
+
+  variable.ssa_variable =
+      ssa.new_variable(variable.name, builder->GetInsertBlock());
+  loop_depth_of[variable.ssa_variable] = loops.size();
+  ssa.write_variable(variable.ssa_variable, builder->GetInsertBlock(),
+                     initial);
+  variable.llvm_val = nullptr;
+}
+
+yalll::Value YALLLVisitorImpl::read_variable(yalll::Value& variable,
+                                             size_t line) {
+  yalll::Value value = variable;
+  value.llvm_val =
+      ssa.read_variable(variable.ssa_variable,
+                        variable.type_info.get_llvm_type(),
+                        builder->GetInsertBlock());
+  if (llvm::isa<llvm::PoisonValue>(value.llvm_val)) {
+    logger->send_error("Variable {} is used in line {} before it's assigned",
+                       variable.name, line);
+  }
+  return value;
+}
+
 std::any YALLLVisitorImpl::visitVar_dec(YALLLParser::Var_decContext* ctx) {
   logger->send_log("Visiting var dec");
   ++*logger;
@@ -243,8 +867,10 @@ std::any YALLLVisitorImpl::visitVar_dec(YALLLParser::Var_decContext* ctx) {
   std::string name = ctx->name->getText();
   auto type_info = typesafety::TypeInformation::from_context_node(ctx->ty);
 
-  cur_scope.add_field(
-      name, yalll::Value(type_info, nullptr, ctx->name->getLine(), name));
+  // assigned later, possibly differently on every path
+  yalll::Value variable(type_info, nullptr, ctx->name->getLine(), name);
+  track_variable(variable, llvm::PoisonValue::get(type_info.get_llvm_type()));
+  cur_scope.add_field(name, std::move(variable));
 
   --*logger;
   return std::any();
@@ -261,10 +887,42 @@ std::any YALLLVisitorImpl::visitVar_def(YALLLParser::Var_defContext* ctx) {
   logger->send_log("Got {} with type: {}", name, type_info.to_string());
 
   if (operation->resolve_with_type_info(type_info)) {
-    cur_scope.add_field(
-        name,
-        yalll::Value(type_info, operation->generate_value().get_llvm_val(),
-                     ctx->getStart()->getLine(), name));
+    yalll::Value variable(type_info,
+                          operation->generate_value().get_llvm_val(),
+                          ctx->getStart()->getLine(), name);
+    // an immutable variable simply is its value
+    if (type_info.is_mutable()) {
+      track_variable(variable, variable.llvm_val);
+    }
+    cur_scope.add_field(name, std::move(variable));
+  }
+
+  --*logger;
+  return std::any();
+}
+
+std::any YALLLVisitorImpl::visitFunction_dec(
+    YALLLParser::Function_decContext* ctx) {
+  std::string name = ctx->NAME()->getText();
+
+  logger->send_log("Visiting function declaration {}", name);
+  ++*logger;
+
+  auto ret_type = typesafety::TypeInformation::from_context_node(ctx->type());
+  auto params =
+      std::any_cast<std::vector<yalll::Value>>(visit(ctx->parameter_list()));
+
+  // top level declarations were already declared with the signatures
+  auto* owner = cur_scope.get_active_class();
+  auto* func = cur_scope.lookup_function(name);
+  if (func && func->get_owner() == (owner ? owner->get_name() : "")) {
+    if (!same_signature(*func, ret_type, params)) {
+      logger->send_error("Declaration of {} in line {} doesn't match an "
+                         "earlier one",
+                         name, ctx->NAME()->getSymbol()->getLine());
+    }
+  } else {
+    (void)declare_function(name, ret_type, params, ctx->NOERR_KW(), false);
   }
 
   --*logger;
@@ -274,6 +932,13 @@ std::any YALLLVisitorImpl::visitVar_def(YALLLParser::Var_defContext* ctx) {
 std::any YALLLVisitorImpl::visitFunction_def(
     YALLLParser::Function_defContext* ctx) {
   std::string name = ctx->func_name->getText();
+  auto* owner = cur_scope.get_active_class();
+  if (reachable &&
+      !reachable->contains(owner ? owner->get_name() + "." + name : name)) {
+    return std::any();
+  }
+  // the other jobs are done with the declaration from the signatures
+  if (job != 0 && !owner && !generates(name)) return std::any();
 
   logger->send_log("Visiting function {}", name);
   ++*logger;
@@ -281,18 +946,137 @@ std::any YALLLVisitorImpl::visitFunction_def(
   auto ret_type = typesafety::TypeInformation::from_context_node(ctx->ret_type);
   auto params = std::any_cast<std::vector<yalll::Value>>(visit(ctx->parm_list));
 
-  cur_scope.push(name);
-  yalll::Function func(name, ret_type, params);
+  // --watch takes unchanged functions from the last compilation, they only
+  // need their declaration, methods are always compiled with their class.
+  // With --jobs the functions of the other jobs are only declared as well.
+  bool reused = cache && !owner &&
+                cache->reuse(name, std::hash<std::string>()(source_text(
+                                       ctx->getStart(), ctx->getStop(), true)));
+  reused |= !generates(owner ? owner->get_name() + "." + name : name);
+
+  // a declared function is defined in place, calls before the definition
+  // already use it
+  auto* func = cur_scope.lookup_function(name);
+  if (func && func->is_declaration() &&
+      func->get_owner() == (owner ? owner->get_name() : "")) {
+    if (!same_signature(*func, ret_type, params)) {
+      logger->send_error(
+          "Definition of {} in line {} doesn't match its declaration", name,
+          ctx->func_name->getLine());
+    }
+    func->get_parameters() = params;
+    if (!reused) func->generate_function_body();
+  } else {
+    func = declare_function(name, ret_type, params, ctx->NOERR_KW(), !reused);
+  }
+
+  // the flags of @fastmath only last until the end of the function
+  llvm::IRBuilderBase::FastMathFlagGuard fast_math_guard(*builder);
+  for (auto* annotation : ctx->annotations) {
+    auto annotation_name = annotation->name->getText();
+    if (annotation_name == "fastmath") {
+      add_fast_math(annotation);
+      continue;
+    }
+    // stays visible with --whole-program
+    if (annotation_name == "export") {
+      exported.insert(func->get_llvm_name());
+      continue;
+    }
+    if (annotation_name != "multiversion") {
+      logger->send_warning("Unknown annotation @{} on function in line {}",
+                           annotation_name, annotation->name->getLine());
+      continue;
+    }
+
+    // @multiversion(avx2, "avx512f")
+    std::vector<std::string> features;
+    for (auto* arg : annotation->args) {
+      auto feature = arg->getText();
+      if (arg->getType() == YALLLParser::STRING)
+        feature = feature.substr(1, feature.size() - 2);
+      if (!Multiversioning::is_known_feature(feature)) {
+        logger->send_error("Unknown feature {} for @multiversion in line {}",
+                           feature, annotation->name->getLine());
+        continue;
+      }
+      features.push_back(feature);
+    }
+    if (features.empty()) {
+      logger->send_error("@multiversion of {} in line {} needs a feature",
+                         name, annotation->name->getLine());
+      continue;
+    }
+    multiversioning.add(func->llvm_func, features,
+                        annotation->name->getLine());
+  }
+  if (reused) {
+    --*logger;
+    return std::any();
+  }
 
-  (void)func.generate_function_sig(*module);
-  cur_scope.add_function(name, std::move(func));
   cur_scope.set_active_function(name);
+  // mutable parameters start out as their argument in the entry block
+  for (auto& param : func->get_parameters()) {
+    if (param.type_info.is_mutable()) track_variable(param, param.llvm_val);
+  }
+  if (debug_info) {
+    debug_info->begin_function(func->llvm_func, func->get_llvm_name(),
+                               ctx->func_name->getLine());
+  }
 
+  cur_scope.push(cur_scope.get_active_function()->get_llvm_name());
+  if (job != 0) logger->set_muted(false);
   visit(ctx->func_block);
+  if (job != 0) logger->set_muted(true);
+  cur_scope.pop();
+  cur_scope.no_active_function();
+  if (debug_info) debug_info->end_function();
+  ssa.clear();
+  loop_depth_of.clear();
 
   --*logger;
   return std::any();
 }
+
+yalll::Function* YALLLVisitorImpl::declare_function(
+    const std::string& name, typesafety::TypeInformation ret_type,
+    std::vector<yalll::Value> params, bool explicit_noerr, bool with_body) {
+  auto* owner = cur_scope.get_active_class();
+  auto llvm_name = owner ? owner->get_name() + "." + name : name;
+  bool noerr = explicit_noerr || callgraph.is_noerr(llvm_name);
+
+  yalll::Function func(name, ret_type, params, noerr);
+  if (owner) {
+    func.make_method(owner->get_name());
+  }
+
+  (void)func.generate_function_sig(*module, with_body);
+  // tailcc guarantees that recursive tail calls reuse the stack frame, even if
+  // the prototypes differ
+  if (callgraph.is_recursive(llvm_name)) {
+    func.llvm_func->setCallingConv(llvm::CallingConv::Tail);
+  }
+  cur_scope.add_function(name, std::move(func));
+  return cur_scope.find_function(name);
+}
+
+bool YALLLVisitorImpl::same_signature(yalll::Function& func,
+                                      typesafety::TypeInformation& ret_type,
+                                      std::vector<yalll::Value>& params) {
+  if (func.get_return_type().get_llvm_type() != ret_type.get_llvm_type() ||
+      func.get_parameters().size() != params.size()) {
+    return false;
+  }
+  for (auto i = 0; i < params.size(); ++i) {
+    if (func.get_parameters().at(i).type_info.get_llvm_type() !=
+        params.at(i).type_info.get_llvm_type()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 std::any YALLLVisitorImpl::visitParameter_list(
     YALLLParser::Parameter_listContext* ctx) {
   logger->send_log("Visiting paramlist");
@@ -323,62 +1107,331 @@ std::any YALLLVisitorImpl::visitIf_else(YALLLParser::If_elseContext* ctx) {
   logger->send_log("Visiting if else");
   ++*logger;
 
-  auto if_true = llvm::BasicBlock::Create(
-      *context, "if_true", module->getFunction(cur_scope.get_scope_ctx_name()));
-  auto if_false = llvm::BasicBlock::Create(
-      *context, "if_false",
-      module->getFunction(cur_scope.get_scope_ctx_name()));
-  auto if_exit = llvm::BasicBlock::Create(
-      *context, "if_exit", module->getFunction(cur_scope.get_scope_ctx_name()));
+  auto* function = builder->GetInsertBlock()->getParent();
+  auto if_true = llvm::BasicBlock::Create(*context, "if_true", function);
+  auto if_false = llvm::BasicBlock::Create(*context, "if_false", function);
+  auto if_exit = llvm::BasicBlock::Create(*context, "if_exit");
 
   auto if_cmp = to_operation(visit(ctx->if_br->cmp));
   if (if_cmp->resolve_with_type_info(typesafety::TypeInformation::BOOL_T())) {
     auto cmp_value = if_cmp->generate_value();
-    builder->CreateCondBr(cmp_value.get_llvm_val(), if_true, if_false);
+    builder->CreateCondBr(
+        cmp_value.get_llvm_val(), if_true, if_false,
+        branch_weights(ctx->if_br->hint, cmp_value.get_llvm_val()));
 
     builder->SetInsertPoint(if_true);
     visit(ctx->if_br->body);
-    builder->CreateBr(if_exit);
+    branch_if_open(if_exit);
 
     builder->SetInsertPoint(if_false);
     for (auto* else_if_br : ctx->else_if_brs) {
-      auto else_if_true = llvm::BasicBlock::Create(*context, "else_if_true",
-                                                   module->getFunction("main"));
-      auto else_if_false = llvm::BasicBlock::Create(
-          *context, "else_if_false", module->getFunction("main"));
+      auto else_if_true =
+          llvm::BasicBlock::Create(*context, "else_if_true", function);
+      auto else_if_false =
+          llvm::BasicBlock::Create(*context, "else_if_false", function);
 
       auto else_if_cmp = to_operation(visit(else_if_br->cmp));
       if (else_if_cmp->resolve_with_type_info(
               typesafety::TypeInformation::BOOL_T())) {
         auto else_if_cmp_value = else_if_cmp->generate_value();
-        builder->CreateCondBr(else_if_cmp_value.get_llvm_val(), else_if_true,
-                              else_if_false);
+        builder->CreateCondBr(
+            else_if_cmp_value.get_llvm_val(), else_if_true, else_if_false,
+            branch_weights(else_if_br->hint, else_if_cmp_value.get_llvm_val()));
 
         builder->SetInsertPoint(else_if_true);
         visit(else_if_br->body);
-        builder->CreateBr(if_exit);
+        branch_if_open(if_exit);
         builder->SetInsertPoint(else_if_false);
       }
     }
 
-    auto else_case = llvm::BasicBlock::Create(*context, "else_case",
-                                              module->getFunction("main"));
     if (ctx->else_br) {
+      auto else_case =
+          llvm::BasicBlock::Create(*context, "else_case", function);
       builder->CreateBr(else_case);
 
       builder->SetInsertPoint(else_case);
       visit(ctx->else_br->body);
     }
+    branch_if_open(if_exit);
+
+    // if every branch returned, nothing can reach the exit
+    if (!if_exit->hasNPredecessors(0)) {
+      if_exit->insertInto(function);
+      builder->SetInsertPoint(if_exit);
+    } else {
+      delete if_exit;
+    }
+  }
+
+  --*logger;
+  return std::any();
+}
+
+std::any YALLLVisitorImpl::visitWhile_loop(
+    YALLLParser::While_loopContext* ctx) {
+  logger->send_log("Visiting while loop");
+  ++*logger;
+
+  auto* function = builder->GetInsertBlock()->getParent();
+  auto* loop_header =
+      llvm::BasicBlock::Create(*context, "loop_header", function);
+  auto* loop_body = llvm::BasicBlock::Create(*context, "loop_body", function);
+  auto* loop_exit = llvm::BasicBlock::Create(*context, "loop_exit");
+
+  // the backedge to the header only exists after the body
+  builder->CreateBr(loop_header);
+  ssa.open_block(loop_header);
+  builder->SetInsertPoint(loop_header);
+
+  auto cmp = to_operation(visit(ctx->cmp));
+  if (cmp->resolve_with_type_info(typesafety::TypeInformation::BOOL_T())) {
+    builder->CreateCondBr(cmp->generate_value().get_llvm_val(), loop_body,
+                          loop_exit);
+  } else {
+    // the body is still checked, it just never runs
+    builder->CreateCondBr(builder->getFalse(), loop_body, loop_exit);
+  }
+
+  builder->SetInsertPoint(loop_body);
+  visit_loop_body(ctx->body, loop_header, loop_exit);
+  end_loop(loop_header, loop_exit);
+
+  --*logger;
+  return std::any();
+}
+
+std::any YALLLVisitorImpl::visitFor_loop(YALLLParser::For_loopContext* ctx) {
+  logger->send_log("Visiting for loop");
+  ++*logger;
+
+  // a variable defined by the loop is only visible inside of it
+  cur_scope.push();
+  if (ctx->init_def) visit(ctx->init_def);
+  if (ctx->init_assign) visit(ctx->init_assign);
+
+  auto* function = builder->GetInsertBlock()->getParent();
+  auto* loop_header =
+      llvm::BasicBlock::Create(*context, "loop_header", function);
+  auto* loop_body = llvm::BasicBlock::Create(*context, "loop_body", function);
+  auto* loop_step = llvm::BasicBlock::Create(*context, "loop_step");
+  auto* loop_exit = llvm::BasicBlock::Create(*context, "loop_exit");
+
+  builder->CreateBr(loop_header);
+  ssa.open_block(loop_header);
+  builder->SetInsertPoint(loop_header);
+
+  // without a condition the loop is only left by break or return
+  auto cmp = ctx->cmp ? to_operation(visit(ctx->cmp)) : nullptr;
+  if (!cmp) {
+    builder->CreateBr(loop_body);
+  } else if (cmp->resolve_with_type_info(
+                 typesafety::TypeInformation::BOOL_T())) {
+    builder->CreateCondBr(cmp->generate_value().get_llvm_val(), loop_body,
+                          loop_exit);
+  } else {
+    builder->CreateCondBr(builder->getFalse(), loop_body, loop_exit);
+  }
+
+  builder->SetInsertPoint(loop_body);
+  visit_loop_body(ctx->body, loop_step, loop_exit);
+
+  // if every iteration returned or broke out, there is nothing to step
+  if (!loop_step->hasNPredecessors(0)) {
+    loop_step->insertInto(function);
+    builder->SetInsertPoint(loop_step);
+    if (ctx->step_assign) visit(ctx->step_assign);
+    if (ctx->step_op) {
+      auto step = to_operation(visit(ctx->step_op));
+      if (step->resolve_without_type_info()) (void)step->generate_value();
+    }
+    branch_if_open(loop_header);
+  } else {
+    delete loop_step;
+  }
+  end_loop(loop_header, loop_exit);
+  cur_scope.pop();
+
+  --*logger;
+  return std::any();
+}
+
+std::any YALLLVisitorImpl::visitForeach_loop(
+    YALLLParser::Foreach_loopContext* ctx) {
+  logger->send_error("Foreach loop in line {} isn't supported yet",
+                     ctx->getStart()->getLine());
+  return std::any();
+}
+
+void YALLLVisitorImpl::visit_loop_body(YALLLParser::Loop_bodyContext* ctx,
+                                       llvm::BasicBlock* next,
+                                       llvm::BasicBlock* exit) {
+  loops.push_back(LoopTargets{next, exit});
+  visit(ctx);
+  loops.pop_back();
+  branch_if_open(next);
+}
+
+void YALLLVisitorImpl::end_loop(llvm::BasicBlock* header,
+                                llvm::BasicBlock* exit) {
+  // every backedge exists now, so the phis of the header can be completed
+  ssa.seal_block(header);
+
+  // the entry of the loop was checked by the assignment itself
+  std::erase_if(loop_assignments, [&](LoopAssignment& assignment) {
+    if (assignment.exit != exit) return false;
+    for (auto* predecessor : llvm::predecessors(header)) {
+      if (ssa.may_be_assigned(assignment.variable, predecessor)) {
+        logger->send_error(
+            "Immutable value {} assigned in line {} may be assigned again by "
+            "the next iteration of the loop",
+            assignment.name, assignment.line);
+        break;
+      }
+    }
+    return true;
+  });
+
+  // an endless loop without break has no exit
+  if (!exit->hasNPredecessors(0)) {
+    exit->insertInto(header->getParent());
+    builder->SetInsertPoint(exit);
+  } else {
+    delete exit;
+  }
+}
+
+std::any YALLLVisitorImpl::visitSwitch_stmt(
+    YALLLParser::Switch_stmtContext* ctx) {
+  logger->send_log("Visiting switch");
+  ++*logger;
+
+  auto subject_op = to_operation(visit(ctx->subject));
+  if (!subject_op->resolve_without_type_info()) {
+    --*logger;
+    return std::any();
+  }
+  auto subject = subject_op->generate_value();
+  if (!subject.get_llvm_val()->getType()->isIntegerTy()) {
+    logger->send_error("Can't switch over {} in line {}, only over integers",
+                       subject.type_info.to_string(),
+                       ctx->getStart()->getLine());
+    --*logger;
+    return std::any();
+  }
+
+  auto* function = builder->GetInsertBlock()->getParent();
+  auto* switch_exit = llvm::BasicBlock::Create(*context, "switch_exit");
+  auto* default_case = switch_exit;
+  if (ctx->body->DEFAULT_KW()) {
+    default_case = llvm::BasicBlock::Create(*context, "switch_default");
+  }
+
+  // LLVM decides between a jump table, bit tests and a binary search
+  auto* switch_inst = builder->CreateSwitch(
+      subject.get_llvm_val(), default_case, ctx->body->cases.size());
+
+  std::map<uint64_t, size_t> labels;
+  std::vector<llvm::BasicBlock*> case_blocks;
+  for (auto* switch_case : ctx->body->cases) {
+    case_blocks.push_back(
+        llvm::BasicBlock::Create(*context, "switch_case", function));
+
+    auto* label = case_label(switch_case->label, subject);
+    if (!label) continue;
+
+    auto line = switch_case->getStart()->getLine();
+    if (labels.contains(label->getZExtValue())) {
+      logger->send_error(
+          "Duplicate case {} in line {}, already used in line {}",
+          switch_case->label->getText(), line,
+          labels.at(label->getZExtValue()));
+      continue;
+    }
+    labels.insert(std::pair<uint64_t, size_t>(label->getZExtValue(), line));
+    switch_inst->addCase(label, case_blocks.back());
+  }
+
+  for (auto i = 0; i < ctx->body->cases.size(); ++i) {
+    builder->SetInsertPoint(case_blocks.at(i));
+    auto& statements = ctx->body->cases.at(i)->statements;
+
+    // a case without statements shares the statements of the next case
+    if (statements.empty()) {
+      builder->CreateBr(i + 1 < case_blocks.size() ? case_blocks.at(i + 1)
+                                                   : default_case);
+      continue;
+    }
+
+    cur_scope.push();
+    visit_statements(statements);
+    cur_scope.pop();
+    branch_if_open(switch_exit);
+  }
 
-    if_exit->moveAfter(else_case);
-    builder->CreateBr(if_exit);
-    builder->SetInsertPoint(if_exit);
+  if (default_case != switch_exit) {
+    default_case->insertInto(function);
+    builder->SetInsertPoint(default_case);
+    cur_scope.push();
+    visit_statements(ctx->body->default_body);
+    cur_scope.pop();
+    branch_if_open(switch_exit);
+  }
+
+  // if every case returned, nothing can reach the exit
+  if (!switch_exit->hasNPredecessors(0)) {
+    switch_exit->insertInto(function);
+    builder->SetInsertPoint(switch_exit);
+  } else {
+    delete switch_exit;
   }
 
   --*logger;
   return std::any();
 }
 
+llvm::ConstantInt* YALLLVisitorImpl::case_label(
+    YALLLParser::Switch_labelContext* ctx, yalll::Value& subject) {
+  auto* type = llvm::cast<llvm::IntegerType>(subject.get_llvm_val()->getType());
+  auto line = ctx->getStart()->getLine();
+
+  if (auto* name = ctx->NAME()) {
+    auto error_name = resolve_error_name(name->getText());
+    if (error_name.empty() || !subject.type_info.is_error()) {
+      logger->send_error(
+          "Case {} in line {} isn't a constant of the switched type",
+          name->getText(), line);
+      return nullptr;
+    }
+    return elut.get_llvm_id(error_name);
+  }
+
+  if (subject.type_info.is_error()) {
+    logger->send_error("Case {} in line {} isn't an error", ctx->getText(),
+                       line);
+    return nullptr;
+  }
+
+  // the label has to be representable in the type of the subject
+  auto text = ctx->getText();
+  bool negative = text.starts_with("-");
+  auto digits = negative ? text.substr(1) : text;
+  auto bits = type->getBitWidth();
+
+  llvm::APInt label(
+      std::max(llvm::APInt::getBitsNeeded(digits, 10), bits) + 1, digits, 10);
+  if (negative) label.negate();
+  bool fits = subject.type_info.is_signed()
+                  ? label.isSignedIntN(bits)
+                  : !label.isNegative() && label.isIntN(bits);
+  if (!fits) {
+    logger->send_error("Case {} in line {} doesn't fit into {}", text, line,
+                       subject.type_info.to_string());
+    return nullptr;
+  }
+  return llvm::ConstantInt::get(*context, label.trunc(bits));
+}
+
 std::any YALLLVisitorImpl::visitIf(YALLLParser::IfContext* ctx) {
   logger->send_internal_error("Visited if instead of if_else");
   return std::any();
@@ -394,6 +1447,41 @@ std::any YALLLVisitorImpl::visitElse(YALLLParser::ElseContext* ctx) {
   return std::any();
 }
 
+std::any YALLLVisitorImpl::visitAnnotated_block(
+    YALLLParser::Annotated_blockContext* ctx) {
+  logger->send_log("Visiting annotated block");
+  ++*logger;
+
+  llvm::IRBuilderBase::FastMathFlagGuard fast_math_guard(*builder);
+  for (auto* annotation : ctx->annotations) {
+    auto annotation_name = annotation->name->getText();
+    if (annotation_name == "fastmath") {
+      add_fast_math(annotation);
+    } else {
+      logger->send_warning("Unknown annotation @{} on block in line {}",
+                           annotation_name, annotation->name->getLine());
+    }
+  }
+  visit(ctx->body);
+
+  --*logger;
+  return std::any();
+}
+
+void YALLLVisitorImpl::add_fast_math(
+    YALLLParser::AnnotationContext* annotation) {
+  // a plain @fastmath enables every flag
+  auto flags = builder->getFastMathFlags();
+  if (annotation->args.empty()) flags.setFast();
+  for (auto* arg : annotation->args) {
+    if (!add_fast_math_flag(flags, arg->getText())) {
+      logger->send_error("Unknown fast math flag {} in line {}",
+                         arg->getText(), annotation->name->getLine());
+    }
+  }
+  builder->setFastMathFlags(flags);
+}
+
 std::any YALLLVisitorImpl::visitOperation(YALLLParser::OperationContext* ctx) {
   logger->send_log("Visiting operation");
   ++*logger;
@@ -403,11 +1491,136 @@ std::any YALLLVisitorImpl::visitOperation(YALLLParser::OperationContext* ctx) {
 }
 
 std::any YALLLVisitorImpl::visitReterr_op(YALLLParser::Reterr_opContext* ctx) {
+  if (!ctx->op) return visit(ctx->val);
+
   logger->send_log("Visiting reterr");
   ++*logger;
-  auto res = visitChildren(ctx);
+
+  auto error = to_operation(visit(ctx->val));
+  auto line = ctx->getStart()->getLine();
+  if (!cur_scope.has_active_function()) {
+    logger->send_error("reterr in line {} outside of a function", line);
+    --*logger;
+    return error;
+  }
+
   --*logger;
-  return res;
+  return std::make_shared<yalll::ReterrOperation>(
+      error, *cur_scope.get_active_function(), line);
+}
+
+std::any YALLLVisitorImpl::visitIserr_op(YALLLParser::Iserr_opContext* ctx) {
+  if (!ctx->op) return visit(ctx->val);
+
+  logger->send_log("Visiting iserr");
+  ++*logger;
+  auto value = to_operation(visit(ctx->val));
+  --*logger;
+  return std::make_shared<yalll::IserrOperation>(value,
+                                                 ctx->getStart()->getLine());
+}
+
+std::any YALLLVisitorImpl::visitOnerr_op(YALLLParser::Onerr_opContext* ctx) {
+  if (ctx->rhs.empty()) return visit(ctx->lhs);
+
+  logger->send_log("Visiting onerr");
+  ++*logger;
+
+  auto lhs = to_operation(visit(ctx->lhs));
+  auto line = ctx->getStart()->getLine();
+  auto call = std::dynamic_pointer_cast<yalll::FuncCallOperation>(lhs);
+  if (!call) {
+    logger->send_error("onerr in line {} needs a function call", line);
+    --*logger;
+    return lhs;
+  }
+  if (ctx->rhs.size() > 1) {
+    logger->send_error("Only a single onerr block per call, line {}", line);
+  }
+
+  auto& callee = call->get_function();
+  if (callee.is_noerr()) {
+    logger->send_warning("onerr in line {} is never run, {} is noerr", line,
+                         callee.get_llvm_name());
+    --*logger;
+    return call;
+  }
+
+  // only the errors the callee can actually return get a handler, the rest is
+  // dead code
+  auto errors = callgraph.get_error_set(callee.get_llvm_name());
+  auto* body = ctx->rhs.front()->switch_();
+  auto& cases = body->cases;
+  std::vector<yalll::OnerrHandler> handlers;
+  std::map<std::string, size_t> labels;
+  for (auto i = 0; i < cases.size(); ++i) {
+    auto* label = cases.at(i)->label;
+    auto case_line = label->getStart()->getLine();
+    auto error_name =
+        label->NAME() ? resolve_error_name(label->getText()) : "";
+    if (error_name.empty()) {
+      logger->send_error("onerr case {} in line {} isn't an error",
+                         label->getText(), case_line);
+      continue;
+    }
+    if (labels.contains(error_name)) {
+      logger->send_error(
+          "Duplicate case {} in line {}, already used in line {}", error_name,
+          case_line, labels.at(error_name));
+      continue;
+    }
+    labels.insert(std::pair<std::string, size_t>(error_name, case_line));
+
+    if (!errors.contains(error_name)) {
+      logger->send_warning("Handler for {} in line {} is dead, {} returns {}",
+                           error_name, case_line, callee.get_llvm_name(),
+                           errors.to_string());
+      continue;
+    }
+
+    // a case without statements shares the statements of the next case, the
+    // index after the last case is the default
+    auto statements = i;
+    while (statements < cases.size() &&
+           cases.at(statements)->statements.empty()) {
+      ++statements;
+    }
+    handlers.push_back(yalll::OnerrHandler{elut.get_llvm_id(error_name),
+                                           static_cast<size_t>(statements)});
+  }
+
+  bool covers_all =
+      !errors.any && std::all_of(errors.errors.begin(), errors.errors.end(),
+                                 [&](const std::string& error) {
+                                   return labels.contains(error);
+                                 });
+  std::optional<size_t> default_body;
+  if (body->DEFAULT_KW()) {
+    if (covers_all) {
+      logger->send_warning(
+          "default of onerr in line {} is dead, every error of {} is handled",
+          line, callee.get_llvm_name());
+    } else {
+      default_body = cases.size();
+    }
+  }
+
+  yalll::Function* caller = nullptr;
+  if (cur_scope.has_active_function()) {
+    caller = cur_scope.get_active_function();
+  }
+
+  --*logger;
+  return std::make_shared<yalll::OnerrOperation>(
+      call, handlers, default_body, covers_all, caller,
+      [this, body](size_t index) {
+        cur_scope.push();
+        visit_statements(index < body->cases.size()
+                             ? body->cases.at(index)->statements
+                             : body->default_body);
+        cur_scope.pop();
+      },
+      line);
 }
 
 std::any YALLLVisitorImpl::visitBool_or_op(
@@ -490,7 +1703,15 @@ std::any YALLLVisitorImpl::visitAddition_op(
   std::vector<std::shared_ptr<yalll::Operation>> operations;
   std::vector<size_t> op_codes;
 
-  operations.push_back(to_operation(visit(ctx->lhs)));
+  // (a + b) - c is a + b - c, continuing the chain of the parentheses keeps
+  // left nested expressions from nesting operations as deep as they are
+  auto lhs = to_operation(visit(ctx->lhs));
+  if (auto chain = std::dynamic_pointer_cast<yalll::AddOperation>(lhs)) {
+    operations = chain->get_values();
+    op_codes = chain->get_ops();
+  } else {
+    operations.push_back(lhs);
+  }
 
   for (auto i = 0; i < ctx->op.size(); ++i) {
     operations.push_back(to_operation(visit(ctx->rhs.at(i))));
@@ -513,7 +1734,14 @@ std::any YALLLVisitorImpl::visitMultiplication_op(
   std::vector<std::shared_ptr<yalll::Operation>> operations;
   std::vector<size_t> op_codes;
 
-  operations.push_back(to_operation(visit(ctx->lhs)));
+  // same as for additions, (a * b) / c is a * b / c
+  auto lhs = to_operation(visit(ctx->lhs));
+  if (auto chain = std::dynamic_pointer_cast<yalll::MulOperation>(lhs)) {
+    operations = chain->get_values();
+    op_codes = chain->get_ops();
+  } else {
+    operations.push_back(lhs);
+  }
 
   for (auto i = 0; i < ctx->op.size(); ++i) {
     operations.push_back(to_operation(visit(ctx->rhs.at(i))));
@@ -544,20 +1772,205 @@ std::any YALLLVisitorImpl::visitPrimary_op_fc(
   return res;
 }
 
+std::any YALLLVisitorImpl::visitPrimary_op_new(
+    YALLLParser::Primary_op_newContext* ctx) {
+  std::string name = ctx->name->getText();
+  logger->send_log("Visiting new {}", name);
+  ++*logger;
+
+  auto* target = cur_scope.find_class(name);
+  if (!target) {
+    logger->send_error("Unknown class {} used with new in line {}", name,
+                       ctx->name->getLine());
+    --*logger;
+    return std::make_shared<yalll::TerminalOperation>(yalll::Value(
+        typesafety::TypeInformation::VOID_T(),
+        llvm::PoisonValue::get(builder->getVoidTy()), ctx->name->getLine()));
+  }
+
+  if (ctx->args->first_arg) {
+    logger->send_error(
+        "Constructor arguments for {} in line {} are not supported yet", name,
+        ctx->name->getLine());
+  }
+
+  // inside of a method new allocates from the object memory of this
+  auto* owner = cur_scope.get_active_class();
+  llvm::Value* owner_ptr = nullptr;
+  if (owner && cur_scope.has_active_function()) {
+    owner_ptr = cur_scope.get_active_function()->this_ptr;
+    owner->register_allocation(cur_scope.get_active_function()->get_name(),
+                               *target, ctx->name->getLine(),
+                               !inside_loop(ctx), module->getDataLayout());
+  } else {
+    owner = nullptr;
+  }
+
+  --*logger;
+  return std::make_shared<yalll::NewOperation>(*target, owner, owner_ptr,
+                                               ctx->name->getLine());
+}
+
 std::any YALLLVisitorImpl::visitFunction_call(
     YALLLParser::Function_callContext* ctx) {
   std::string name = ctx->name->getText();
   logger->send_log("Visiting function {} call", name);
   ++*logger;
 
-  auto* func = cur_scope.find_function(name);
+  // builtin::name(...) is always a builtin, a plain name(...) only if there
+  // is no function with that name
+  bool builtin_scope = false;
+  if (ctx->scope) {
+    builtin_scope = ctx->scope->getText() == yalll::BUILTIN_NAMESPACE;
+    if (!builtin_scope) {
+      logger->send_error("Unknown namespace {} in line {}",
+                         ctx->scope->getText(), ctx->name->getLine());
+      --*logger;
+      return std::make_shared<yalll::TerminalOperation>(yalll::Value(
+          typesafety::TypeInformation::VOID_T(),
+          llvm::PoisonValue::get(builder->getVoidTy()), ctx->name->getLine()));
+    }
+  }
+
+  auto* func = is_builtin_call(ctx) ? nullptr : cur_scope.lookup_function(name);
+  if (!func && yalll::is_builtin(name)) {
+    --*logger;
+    return builtin_call(ctx);
+  }
+  if (!func) {
+    logger->send_error("Unknown {} {} called in line {}",
+                       builtin_scope ? "builtin" : "function", name,
+                       ctx->name->getLine());
+    --*logger;
+    return std::make_shared<yalll::TerminalOperation>(yalll::Value(
+        typesafety::TypeInformation::VOID_T(),
+        llvm::PoisonValue::get(builder->getVoidTy()), ctx->name->getLine()));
+  }
   auto arguments =
       std::any_cast<std::vector<std::shared_ptr<yalll::Operation>>>(
           visit(ctx->args));
 
+  // methods calling each other pass on their own object
+  llvm::Value* this_ptr = nullptr;
+  if (func->is_method() && cur_scope.has_active_function()) {
+    this_ptr = cur_scope.get_active_function()->this_ptr;
+    // the object memory of this is shared by both methods
+    if (auto* owner = cur_scope.get_active_class()) {
+      owner->register_method_call(cur_scope.get_active_function()->get_name(),
+                                  name, !inside_loop(ctx));
+    }
+  }
+
+  auto call = std::make_shared<yalll::FuncCallOperation>(
+      yalll::FuncCallOperation(*func, arguments, this_ptr));
+  // errors that aren't checked or handled are returned to our caller
+  if (cur_scope.has_active_function() &&
+      cur_scope.get_active_function()->can_return_errors() &&
+      !analysis::checking_iserr(ctx) && !analysis::handling_onerr(ctx)) {
+    call->propagate_errors_to(*cur_scope.get_active_function());
+  }
+  for (auto* annotation : ctx->annotations) {
+    auto annotation_name = annotation->name->getText();
+    if (annotation_name == "tailcall") {
+      if (!is_returned(ctx)) {
+        logger->send_error("@tailcall {} in line {} isn't returned directly",
+                           name, ctx->name->getLine());
+      }
+      call->require_tail_call();
+    } else {
+      logger->send_warning("Unknown annotation @{} on call in line {}",
+                           annotation_name, annotation->name->getLine());
+    }
+  }
+
   --*logger;
-  return std::make_shared<yalll::FuncCallOperation>(
-      yalll::FuncCallOperation(*func, arguments));
+  return call;
+}
+
+bool YALLLVisitorImpl::is_builtin_call(
+    YALLLParser::Function_callContext* ctx) {
+  // the call graph has to agree, it decides which calls can return errors.
+  // Without one (--stream) only the functions declared so far are known.
+  if (callgraph.get_nodes().empty()) {
+    return ctx->scope ||
+           (!cur_scope.lookup_function(ctx->name->getText()) &&
+            yalll::is_builtin(ctx->name->getText()));
+  }
+  auto* owner = cur_scope.get_active_class();
+  return callgraph.is_builtin_call(ctx, owner ? owner->get_name() : "");
+}
+
+std::shared_ptr<yalll::Operation> YALLLVisitorImpl::builtin_call(
+    YALLLParser::Function_callContext* ctx) {
+  auto name = ctx->name->getText();
+  auto line = ctx->name->getLine();
+  if (auto kind = yalll::VectorOperation::from_name(name)) {
+    return vector_builtin(*kind, ctx);
+  }
+
+  auto kind = *yalll::IntrinsicOperation::from_name(name);
+  auto arguments =
+      std::any_cast<std::vector<std::shared_ptr<yalll::Operation>>>(
+          visit(ctx->args));
+  if (arguments.size() != yalll::IntrinsicOperation::operand_count(kind)) {
+    logger->send_error("{} in line {} takes {} arguments, got {}", name, line,
+                       yalll::IntrinsicOperation::operand_count(kind),
+                       arguments.size());
+    return std::make_shared<yalll::TerminalOperation>(
+        yalll::Value(typesafety::TypeInformation::VOID_T(),
+                     llvm::PoisonValue::get(builder->getVoidTy()), line));
+  }
+  return std::make_shared<yalll::IntrinsicOperation>(kind, arguments, name,
+                                                     line);
+}
+
+std::shared_ptr<yalll::Operation> YALLLVisitorImpl::vector_builtin(
+    yalll::VectorOperation::Kind kind, YALLLParser::Function_callContext* ctx) {
+  auto name = ctx->name->getText();
+  auto line = ctx->name->getLine();
+  std::vector<YALLLParser::OperationContext*> args;
+  if (ctx->args->first_arg) {
+    args.push_back(ctx->args->first_arg);
+    args.insert(args.end(), ctx->args->nth_arg.begin(),
+                ctx->args->nth_arg.end());
+  }
+
+  // splat and shuffle take their lanes as constants, the shape of a vector
+  // has to be known at compile time
+  auto count = yalll::VectorOperation::operand_count(kind);
+  bool takes_constants = kind == yalll::VectorOperation::Kind::Splat ||
+                         kind == yalll::VectorOperation::Kind::Shuffle;
+  if (args.size() < count || (!takes_constants && args.size() != count) ||
+      (takes_constants && args.size() == count)) {
+    logger->send_error("Wrong number of arguments for {} in line {}", name,
+                       line);
+    return std::make_shared<yalll::TerminalOperation>(
+        yalll::Value(typesafety::TypeInformation::VOID_T(),
+                     llvm::PoisonValue::get(builder->getVoidTy()), line));
+  }
+
+  std::vector<std::shared_ptr<yalll::Operation>> operands;
+  for (auto i = 0; i < count; ++i) {
+    operands.push_back(to_operation(visit(args.at(i))));
+  }
+  std::vector<int> constants;
+  for (auto i = count; i < args.size(); ++i) {
+    auto text = args.at(i)->getText();
+    // anything longer can't be a lane and doesn't fit into an int
+    bool is_lane = !text.empty() && text.size() <= 9 &&
+                   std::all_of(text.begin(), text.end(), [](char c) {
+                     return std::isdigit(static_cast<unsigned char>(c));
+                   });
+    if (!is_lane) {
+      logger->send_error("{} in line {} takes constant lanes, got {}", name,
+                         line, text);
+      continue;
+    }
+    constants.push_back(std::stoi(text));
+  }
+
+  return std::make_shared<yalll::VectorOperation>(kind, operands, constants,
+                                                  line);
 }
 
 std::any YALLLVisitorImpl::visitArgument_list(
@@ -603,10 +2016,26 @@ std::any YALLLVisitorImpl::visitTerminal_op(
                        ctx->val->getText(), ctx->val->getLine()));
 
     case YALLLParser::NAME: {
+      // variables shadow errors with the same name
+      auto error_name = cur_scope.has_field(ctx->val->getText())
+                            ? ""
+                            : resolve_error_name(ctx->val->getText());
+      if (!error_name.empty()) {
+        logger->send_log("Error {}", error_name);
+        --*logger;
+        return std::make_shared<yalll::TerminalOperation>(yalll::Value(
+            typesafety::TypeInformation::ERROR_T(),
+            elut.get_llvm_id(error_name), ctx->val->getLine()));
+      }
+
       auto* value = cur_scope.find_field(ctx->val->getText());
-      logger->send_log("{}", value->to_string());
       if (value) {
+        logger->send_log("{}", value->to_string());
         --*logger;
+        if (value->ssa_variable) {
+          return std::make_shared<yalll::TerminalOperation>(
+              read_variable(*value, ctx->val->getLine()));
+        }
         return std::make_shared<yalll::TerminalOperation>(*value);
       } else {
         logger->send_error("Undefined variable {} used inline {}",
@@ -6,11 +6,24 @@
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/Support/raw_ostream.h>
 
+#include <map>
 #include <memory>
+#include <optional>
+#include <set>
+#include <string>
 
+#include "../analysis/callgraph.h"
+#include "../analysis/effects.h"
+#include "../debuginfo/debuginfo.h"
+#include "../elut/elut.h"
 #include "../import/import.h"
 #include "../logging/logger.h"
+#include "../operation/vectoroperation.h"
 #include "../scoping/scope.h"
+#include "../target/multiversion.h"
+#include "../target/target.h"
+#include "incremental.h"
+#include "ssabuilder.h"
 #include "YALLLBaseVisitor.h"
 #include "YALLLParser.h"
 
@@ -18,10 +31,22 @@ namespace yallc {
 
 class YALLLVisitorImpl : public YALLLBaseVisitor {
  public:
-  YALLLVisitorImpl(std::string out_path);
+  // cache is only given by --watch
+  YALLLVisitorImpl(std::string out_path, std::string source_path,
+                   IncrementalCache* cache = nullptr);
   ~YALLLVisitorImpl();
 
   std::any visitProgram(YALLLParser::ProgramContext* ctx) override;
+  // --stream, instead of visiting the whole program every top level item is
+  // visited on its own, in source order
+  void begin_stream();
+  void visit_top_level(YALLLParser::Top_levelContext* ctx);
+  void end_stream();
+  // --jobs, generates the top level functions of job into a module of its
+  // own and returns it as bitcode, every other function is only declared
+  std::string generate_fragment(YALLLParser::ProgramContext* ctx,
+                                const std::map<std::string, unsigned>& job_of,
+                                unsigned job);
   std::any visitInterface(YALLLParser::InterfaceContext* ctx) override;
   std::any visitClass(YALLLParser::ClassContext* ctx) override;
   std::any visitEntry_point(YALLLParser::Entry_pointContext* ctx) override;
@@ -33,20 +58,34 @@ class YALLLVisitorImpl : public YALLLBaseVisitor {
 
   // Declarations
   std::any visitVar_dec(YALLLParser::Var_decContext* ctx) override;
+  std::any visitFunction_dec(YALLLParser::Function_decContext* ctx) override;
 
   // Definitions
   std::any visitVar_def(YALLLParser::Var_defContext* ctx) override;
   std::any visitFunction_def(YALLLParser::Function_defContext* ctx) override;
 
+  // Loops
+  std::any visitWhile_loop(YALLLParser::While_loopContext* ctx) override;
+  std::any visitFor_loop(YALLLParser::For_loopContext* ctx) override;
+  std::any visitForeach_loop(YALLLParser::Foreach_loopContext* ctx) override;
+
+  // Switch
+  std::any visitSwitch_stmt(YALLLParser::Switch_stmtContext* ctx) override;
+
   // If_Else
   std::any visitIf_else(YALLLParser::If_elseContext* ctx) override;
   std::any visitIf(YALLLParser::IfContext* ctx) override;
   std::any visitElse_if(YALLLParser::Else_ifContext* ctx) override;
   std::any visitElse(YALLLParser::ElseContext* ctx) override;
 
+  std::any visitAnnotated_block(
+      YALLLParser::Annotated_blockContext* ctx) override;
+
   // Operations
   std::any visitOperation(YALLLParser::OperationContext* ctx) override;
   std::any visitReterr_op(YALLLParser::Reterr_opContext* ctx) override;
+  std::any visitIserr_op(YALLLParser::Iserr_opContext* ctx) override;
+  std::any visitOnerr_op(YALLLParser::Onerr_opContext* ctx) override;
   std::any visitBool_or_op(YALLLParser::Bool_or_opContext* ctx) override;
   std::any visitBool_and_op(YALLLParser::Bool_and_opContext* ctx) override;
   std::any visitCompare_op(YALLLParser::Compare_opContext* ctx) override;
@@ -58,6 +97,8 @@ class YALLLVisitorImpl : public YALLLBaseVisitor {
   std::any visitPrimary_op_high_precedence(
       YALLLParser::Primary_op_high_precedenceContext* ctx) override;
   std::any visitPrimary_op_fc(YALLLParser::Primary_op_fcContext* ctx) override;
+  std::any visitPrimary_op_new(
+      YALLLParser::Primary_op_newContext* ctx) override;
   std::any visitPrimary_op_term(
       YALLLParser::Primary_op_termContext* ctx) override;
   // ==========================================================================
@@ -75,7 +116,90 @@ class YALLLVisitorImpl : public YALLLBaseVisitor {
   void trigger_function_return();
   void value_is_error();
 
+  // everything known about the program before any body is generated, the
+  // errors, the call graph and the signatures of the top level functions
+  void prepare(YALLLParser::ProgramContext* ctx);
+  void collect_errors(YALLLParser::ProgramContext* ctx);
+  void declare_signatures(YALLLParser::ProgramContext* ctx);
+  // declares the function of the definition in the active class (if any),
+  // unless it is declared already or unreachable
+  void declare_signature(YALLLParser::Function_defContext* function_def);
+  void register_error(YALLLParser::Error_defContext* error_def,
+                      const std::string& prefix);
+  // passes over the finished module and printing it
+  void finish_module();
+
+  void visit_statements(
+      const std::vector<YALLLParser::StatementContext*>& statements);
+  llvm::ConstantInt* case_label(YALLLParser::Switch_labelContext* ctx,
+                                yalll::Value& subject);
+
+  yalll::Function* declare_function(const std::string& name,
+                                    typesafety::TypeInformation ret_type,
+                                    std::vector<yalll::Value> params,
+                                    bool explicit_noerr, bool with_body);
+  bool same_signature(yalll::Function& func,
+                      typesafety::TypeInformation& ret_type,
+                      std::vector<yalll::Value>& params);
+  std::string resolve_error_name(const std::string& name);
+  void collect_reachable();
+  // false if another job generates the function
+  bool generates(const std::string& llvm_name) const;
+  size_t interface_hash(YALLLParser::ProgramContext* ctx);
+  // hands the variable over to the SSABuilder, starting out with initial
+  void track_variable(yalll::Value& variable, llvm::Value* initial);
+  // the value a tracked variable has at the insert point
+  yalll::Value read_variable(yalll::Value& variable, size_t line);
+  void visit_loop_body(YALLLParser::Loop_bodyContext* ctx,
+                       llvm::BasicBlock* next, llvm::BasicBlock* exit);
+  void end_loop(llvm::BasicBlock* header, llvm::BasicBlock* exit);
+  // @fastmath(reassoc, ...) on top of the flags already in effect
+  void add_fast_math(YALLLParser::AnnotationContext* annotation);
+  // a plain name is a builtin unless a function of the program shadows it
+  bool is_builtin_call(YALLLParser::Function_callContext* ctx);
+  std::shared_ptr<yalll::Operation> builtin_call(
+      YALLLParser::Function_callContext* ctx);
+  std::shared_ptr<yalll::Operation> vector_builtin(
+      yalll::VectorOperation::Kind kind,
+      YALLLParser::Function_callContext* ctx);
+
   scoping::Scope cur_scope;
+  yalll::ELUT elut;
+  analysis::CallGraph callgraph;
+  // only with -g
+  std::unique_ptr<yalll::DebugInfo> debug_info;
+  Target target;
+  Multiversioning multiversioning;
+  SSABuilder ssa;
+
+  // continue jumps to next, break to exit
+  struct LoopTargets {
+    llvm::BasicBlock* next;
+    llvm::BasicBlock* exit;
+  };
+  // innermost loop last
+  std::vector<LoopTargets> loops;
+  // an immutable variable assigned inside of a loop, the loop is known by
+  // its exit. Once every backedge exists, end_loop checks that the next
+  // iteration can't assign it again.
+  struct LoopAssignment {
+    SSABuilder::Variable variable;
+    std::string name;
+    size_t line;
+    llvm::BasicBlock* exit;
+  };
+  std::vector<LoopAssignment> loop_assignments;
+  // the number of loops around the declaration of every tracked variable
+  std::map<SSABuilder::Variable, size_t> loop_depth_of;
+  // llvm names of the @export functions
+  std::set<std::string> exported;
+  // llvm names of the functions to compile, only with --reachable-only
+  std::optional<std::set<std::string>> reachable;
+  IncrementalCache* cache;
+  // only with --jobs, the job of every top level function and the job of
+  // this visitor
+  const std::map<std::string, unsigned>* job_of = nullptr;
+  unsigned job = 0;
 
   std::string out_path;
 };
@@ -0,0 +1,56 @@
+#include "debuginfo.h"
+
+#include <llvm/BinaryFormat/Dwarf.h>
+
+#include <filesystem>
+
+namespace yalll {
+
+DebugInfo::DebugInfo(llvm::Module& module, const std::string& source_path,
+                     bool optimized)
+    : di_builder(module), optimized(optimized) {
+  auto path = std::filesystem::absolute(source_path);
+  file = di_builder.createFile(path.filename().string(),
+                               path.parent_path().string());
+  // DWARF has no language id for YALLL, C is what debuggers handle best
+  compile_unit = di_builder.createCompileUnit(llvm::dwarf::DW_LANG_C, file,
+                                              "yallc", optimized, "", 0);
+
+  module.addModuleFlag(llvm::Module::Warning, "Debug Info Version",
+                       llvm::DEBUG_METADATA_VERSION);
+  module.addModuleFlag(llvm::Module::Warning, "Dwarf Version", 5);
+  logger->send_log("Generating debug info for {}", path.string());
+}
+
+void DebugInfo::begin_function(llvm::Function* function,
+                               const std::string& name, size_t line) {
+  // only line tables, so the signature isn't described
+  auto* type =
+      di_builder.createSubroutineType(di_builder.getOrCreateTypeArray({}));
+  auto flags = llvm::DISubprogram::SPFlagDefinition;
+  if (optimized) flags |= llvm::DISubprogram::SPFlagOptimized;
+  if (function->hasLocalLinkage())
+    flags |= llvm::DISubprogram::SPFlagLocalToUnit;
+
+  subprogram = di_builder.createFunction(
+      file, name, function->getName(), file, line, type, line,
+      llvm::DINode::FlagPrototyped, flags);
+  function->setSubprogram(subprogram);
+  set_location(line, 0);
+}
+
+void DebugInfo::set_location(size_t line, size_t column) {
+  if (!subprogram) return;
+  builder->SetCurrentDebugLocation(llvm::DILocation::get(
+      subprogram->getContext(), line, column, subprogram));
+}
+
+void DebugInfo::end_function() {
+  if (subprogram) di_builder.finalizeSubprogram(subprogram);
+  subprogram = nullptr;
+  // a location must never leak into another function
+  builder->SetCurrentDebugLocation(llvm::DebugLoc());
+}
+
+void DebugInfo::finalize() { di_builder.finalize(); }
+}  // namespace yalll
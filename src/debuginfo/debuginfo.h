@@ -0,0 +1,45 @@
+#pragma once
+
+#include <llvm/IR/DIBuilder.h>
+#include <llvm/IR/DebugInfoMetadata.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Module.h>
+
+#include <string>
+
+#include "../import/import.h"
+#include "../logging/logger.h"
+
+namespace yalll {
+
+// DWARF line tables for the generated code (-g)
+// Every function gets a subprogram and every statement a location, so
+// profilers and debuggers can map instructions back to YALLL source lines.
+// Everything generated for a statement shares its location.
+class DebugInfo {
+ public:
+  DebugInfo(llvm::Module& module, const std::string& source_path,
+            bool optimized);
+
+  // the body of function is generated next, its prologue gets line
+  void begin_function(llvm::Function* function, const std::string& name,
+                      size_t line);
+  // instructions generated from now on belong to line:column
+  void set_location(size_t line, size_t column);
+  void end_function();
+
+  // has to be called before the module is verified or printed
+  void finalize();
+
+ private:
+  Import<llvm::IRBuilder<>> builder;
+  Import<util::Logger> logger;
+
+  llvm::DIBuilder di_builder;
+  llvm::DIFile* file;
+  llvm::DICompileUnit* compile_unit;
+  llvm::DISubprogram* subprogram = nullptr;
+  bool optimized;
+};
+}  // namespace yalll
@@ -0,0 +1,147 @@
+#include "elut.h"
+
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/IRBuilder.h>
+
+#include <limits>
+
+namespace yalll {
+
+bool ELUT::register_error(const std::string& name, const std::string& message,
+                          size_t line) {
+  if (errors.contains(name)) {
+    logger->send_error("Error {} in line {} was already defined in line {}",
+                       name, line, entries.at(errors.at(name) - 1).line);
+    return false;
+  }
+  if (entries.size() == std::numeric_limits<uint16_t>::max()) {
+    logger->send_error("Too many errors defined, {} in line {} doesn't fit",
+                       name, line);
+    return false;
+  }
+
+  uint16_t id = entries.size() + 1;
+  errors.insert(std::pair<std::string, uint16_t>(name, id));
+  entries.push_back(ErrorEntry{name, message, id, line});
+  logger->send_log("Registered error {} with id {}", name, id);
+  return true;
+}
+
+uint16_t ELUT::get_id(const std::string& name) {
+  if (!errors.contains(name)) {
+    logger->send_internal_error("Error {} is not in the ELUT", name);
+    return NO_ERROR_ID;
+  }
+  return errors.at(name);
+}
+
+llvm::ConstantInt* ELUT::get_llvm_id(const std::string& name) {
+  Import<llvm::LLVMContext> context;
+  return llvm::ConstantInt::get(llvm::Type::getInt16Ty(*context),
+                                get_id(name));
+}
+
+void ELUT::generate(llvm::Module& module) {
+  auto& context = module.getContext();
+  auto* i32 = llvm::Type::getInt32Ty(context);
+
+  // identical messages share their bytes in the string table
+  std::string strings;
+  std::map<std::string, uint32_t> string_offsets;
+  auto intern = [&](const std::string& message) -> uint32_t {
+    if (string_offsets.contains(message)) return string_offsets.at(message);
+
+    uint32_t offset = strings.size();
+    strings.append(message);
+    strings.push_back('\0');
+    string_offsets.insert(std::pair<std::string, uint32_t>(message, offset));
+    return offset;
+  };
+
+  // offsets instead of pointers keep the table free of relocations, so it
+  // ends up in read only data
+  std::vector<llvm::Constant*> offsets{
+      llvm::ConstantInt::get(i32, intern("no error"))};
+  for (auto& entry : entries) {
+    offsets.push_back(llvm::ConstantInt::get(i32, intern(entry.message)));
+  }
+  logger->send_log("ELUT holds {} errors in {} bytes of messages",
+                   entries.size(), strings.size());
+
+  auto* string_data = llvm::ConstantDataArray::getString(context, strings,
+                                                         /*AddNull=*/false);
+  string_table = new llvm::GlobalVariable(
+      module, string_data->getType(), true,
+      llvm::GlobalValue::PrivateLinkage, string_data, "yalll.elut.strings");
+  string_table->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+
+  auto* offset_type = llvm::ArrayType::get(i32, offsets.size());
+  offset_table = new llvm::GlobalVariable(
+      module, offset_type, true, llvm::GlobalValue::PrivateLinkage,
+      llvm::ConstantArray::get(offset_type, offsets), "yalll.elut");
+  offset_table->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+
+  // ptr yalll.elut.message(i16 id)
+  llvm::IRBuilder<> elut_builder(context);
+  message_lookup = llvm::Function::Create(
+      llvm::FunctionType::get(llvm::PointerType::get(context, 0),
+                              {llvm::Type::getInt16Ty(context)}, false),
+      llvm::Function::InternalLinkage, "yalll.elut.message", module);
+  auto* id = message_lookup->getArg(0);
+  id->setName("id");
+
+  elut_builder.SetInsertPoint(
+      llvm::BasicBlock::Create(context, "entry", message_lookup));
+  auto* offset_ptr = elut_builder.CreateInBoundsGEP(
+      offset_type, offset_table,
+      {elut_builder.getInt64(0), elut_builder.CreateZExt(id, i32)});
+  auto* offset = elut_builder.CreateLoad(i32, offset_ptr, "offset");
+  elut_builder.CreateRet(elut_builder.CreateInBoundsGEP(
+      elut_builder.getInt8Ty(), string_table, offset, "message"));
+
+  generate_report(module);
+}
+
+llvm::FunctionCallee ELUT::get_report(llvm::Module& module) {
+  auto& context = module.getContext();
+  return module.getOrInsertFunction(
+      "yalll.elut.report",
+      llvm::FunctionType::get(llvm::Type::getVoidTy(context),
+                              {llvm::Type::getInt16Ty(context)}, false));
+}
+
+void ELUT::generate_report(llvm::Module& module) {
+  auto& context = module.getContext();
+  auto* ptr = llvm::PointerType::get(context, 0);
+  auto* size = module.getDataLayout().getIntPtrType(context);
+
+  // main may already call it
+  auto* report = llvm::cast<llvm::Function>(get_report(module).getCallee());
+  report->setLinkage(llvm::Function::InternalLinkage);
+  report->addFnAttr(llvm::Attribute::Cold);
+  report->addFnAttr(llvm::Attribute::NoInline);
+  auto* id = report->getArg(0);
+  id->setName("id");
+
+  // only the C library is there at runtime, write(2) doesn't need stdio
+  auto strlen_func = module.getOrInsertFunction(
+      "strlen", llvm::FunctionType::get(size, {ptr}, false));
+  auto write_func = module.getOrInsertFunction(
+      "write", llvm::FunctionType::get(
+                   size, {llvm::Type::getInt32Ty(context), ptr, size}, false));
+
+  llvm::IRBuilder<> report_builder(
+      llvm::BasicBlock::Create(context, "entry", report));
+  auto* message = report_builder.CreateCall(message_lookup, {id}, "message");
+  auto* length = report_builder.CreateCall(strlen_func, {message}, "length");
+  auto* stderr_fd = report_builder.getInt32(2);
+  report_builder.CreateCall(write_func, {stderr_fd, message, length});
+  auto* newline =
+      report_builder.CreateGlobalStringPtr("\n", "yalll.elut.newline");
+  report_builder.CreateCall(
+      write_func, {stderr_fd, newline, llvm::ConstantInt::get(size, 1)});
+  report_builder.CreateRetVoid();
+}
+
+}  // namespace yalll
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Function.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/Module.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "../import/import.h"
+#include "../logging/logger.h"
+
+namespace yalll {
+
+struct ErrorEntry {
+  std::string name;
+  std::string message;
+  uint16_t id;
+  size_t line;
+};
+
+// Error Look Up Table
+// Every error defined in the program gets a dense 16 bit id, 0 means no
+// error. The messages are deduplicated into a single string table, that is
+// only touched if a message is actually needed.
+class ELUT {
+ public:
+  static constexpr uint16_t NO_ERROR_ID = 0;
+  // exit status of a program ended by an error escaping main
+  static constexpr int ERROR_EXIT_STATUS = 1;
+
+  bool register_error(const std::string& name, const std::string& message,
+                      size_t line);
+
+  bool contains(const std::string& name) const {
+    return errors.contains(name);
+  }
+  uint16_t get_id(const std::string& name);
+  llvm::ConstantInt* get_llvm_id(const std::string& name);
+  size_t size() const { return entries.size(); }
+
+  // emits the table as constant globals, the message lookup function
+  // ptr yalll.elut.message(i16 id) and the report of an error escaping main
+  void generate(llvm::Module& module);
+  // void yalll.elut.report(i16 id), writes the message of id to stderr. It
+  // can be called before the ELUT is generated.
+  static llvm::FunctionCallee get_report(llvm::Module& module);
+
+ private:
+  Import<util::Logger> logger;
+
+  std::map<std::string, uint16_t> errors;
+  std::vector<ErrorEntry> entries;
+
+  llvm::GlobalVariable* string_table = nullptr;
+  llvm::GlobalVariable* offset_table = nullptr;
+  llvm::Function* message_lookup = nullptr;
+
+  void generate_report(llvm::Module& module);
+};
+}  // namespace yalll
@@ -1,9 +1,12 @@
 #include "function.h"
 
+#include <llvm/IR/Constants.h>
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Type.h>
 
+#include "../compiler/compileroptions.h"
+#include "../elut/elut.h"
 #include "../import/import.h"
 #include "../typesafety/typesafety.h"
 
@@ -16,9 +19,11 @@ Function& Function::operator=(const Function& other) {
   return_type = other.return_type;
   parameter_list = other.parameter_list;
   ret_val = other.ret_val;
-  elut_ptr = other.elut_ptr;
+  err_id_ptr = other.err_id_ptr;
+  this_ptr = other.this_ptr;
   llvm_func = other.llvm_func;
   noerr = other.noerr;
+  owner = other.owner;
 
   return *this;
 }
@@ -28,9 +33,11 @@ Function& Function::operator=(Function&& other) {
   return_type = other.return_type;
   parameter_list = other.parameter_list;
   ret_val = other.ret_val;
-  elut_ptr = other.elut_ptr;
+  err_id_ptr = other.err_id_ptr;
+  this_ptr = other.this_ptr;
   llvm_func = other.llvm_func;
   noerr = other.noerr;
+  owner = other.owner;
 
   return *this;
 }
@@ -44,56 +51,98 @@ std::vector<llvm::Type*> Function::param_list_to_type_list() {
   return std::move(type_list);
 }
 
-llvm::Function* Function::generate_function_sig(llvm::Module& module) {
+llvm::Function* Function::generate_function_sig(llvm::Module& module,
+                                                bool with_body) {
   logger->send_log("Generating function sig for {}:{} in module {}", name,
                    return_type.to_string(), module.getName().str());
   auto type_list = param_list_to_type_list();
 
-  llvm::FunctionType* function_type;
-  if (noerr) {
-    function_type =
-        llvm::FunctionType::get(return_type.get_llvm_type(), type_list, false);
-  } else {
-    // add implicit pointer for return type
+  if (is_method()) {
     type_list.insert(type_list.begin(),
                      llvm::PointerType::get(module.getContext(), 0));
+  }
+
+  auto& context = module.getContext();
+  auto* err_id_type = llvm::Type::getInt16Ty(context);
 
-    // for normal function return type is always pointer to ELUT
-    function_type = llvm::FunctionType::get(
-        llvm::PointerType::get(module.getContext(), 0), type_list, false);
+  llvm::FunctionType* function_type;
+  switch (get_return_convention()) {
+    case ReturnConvention::Direct:
+      function_type = llvm::FunctionType::get(return_type.get_llvm_type(),
+                                              type_list, false);
+      break;
+    case ReturnConvention::Registers:
+      // {T, error id} is returned as a whole, void only needs the error id
+      function_type = llvm::FunctionType::get(
+          return_type.get_yalll_type() == YALLLParser::VOID_T
+              ? static_cast<llvm::Type*>(err_id_type)
+              : llvm::StructType::get(context,
+                                      {return_type.get_llvm_type(),
+                                       err_id_type}),
+          type_list, false);
+      break;
+    case ReturnConvention::ReturnPointer:
+      // add implicit pointer for return type
+      type_list.insert(type_list.begin(), llvm::PointerType::get(context, 0));
+
+      // return type is always the id of an error in the ELUT, 0 meaning no
+      // error
+      function_type = llvm::FunctionType::get(err_id_type, type_list, false);
+      break;
   }
 
   llvm::Function* function = llvm::Function::Create(
-      function_type, llvm::Function::ExternalLinkage, name, module);
+      function_type, llvm::Function::ExternalLinkage, get_llvm_name(), module);
 
-  if (!noerr) {
-    function->arg_begin()->setName("retptr");
+  if (!function) {
+    logger->send_internal_error("Failed to generate function sig for {}", name);
   }
+  llvm_func = function;
+  logger->send_log("llvm_func: {}; function: {}", llvm_func != nullptr,
+                   function != nullptr);
 
-  // + 1 offset for implicit pointer to return value
-  uint8_t offset = noerr ? 0 : 1;
-  for (auto i = 0; i < parameter_list.size(); ++i) {
-    (function->arg_begin() + offset + i)->setName(parameter_list.at(i).name);
-    parameter_list.at(i).llvm_val = (function->arg_begin() + 1 + i);
+  if (get_return_convention() == ReturnConvention::ReturnPointer) {
+    function->arg_begin()->setName("retptr");
   }
+  bind_parameters();
   logger->send_log("{} takes {} arguments and is {}", name,
-                   function->arg_size() - offset, noerr ? "noerr" : "errable");
+                   parameter_list.size(), noerr ? "noerr" : "errable");
+
+  if (with_body) generate_function_body();
+  return function;
+}
+
+void Function::generate_function_body() {
+  // the definition of a declared function may name its parameters differently
+  bind_parameters();
 
-  Import<llvm::LLVMContext> context;
   Import<llvm::IRBuilder<>> builder;
-  auto body = llvm::BasicBlock::Create(*context, "entry", function);
+  auto body = llvm::BasicBlock::Create(llvm_func->getContext(), "entry",
+                                       llvm_func);
   builder->SetInsertPoint(body);
 
-  if (!noerr)
-    elut_ptr = builder->CreateAlloca(builder->getPtrTy(), nullptr, "elut_ptr");
+  if (!noerr) {
+    err_id_ptr =
+        builder->CreateAlloca(builder->getInt16Ty(), nullptr, "err_id_ptr");
+    builder->CreateStore(builder->getInt16(0), err_id_ptr);
+  }
+}
+
+void Function::bind_parameters() {
+  // + 1 offset for implicit pointer to return value
+  uint8_t offset = 0;
+  if (get_return_convention() == ReturnConvention::ReturnPointer) ++offset;
 
-  if (!function) {
-    logger->send_internal_error("Failed to generate function sig for {}", name);
+  if (is_method()) {
+    this_ptr = llvm_func->arg_begin() + offset;
+    this_ptr->setName("this");
+    ++offset;
+  }
+
+  for (auto i = 0; i < parameter_list.size(); ++i) {
+    (llvm_func->arg_begin() + offset + i)->setName(parameter_list.at(i).name);
+    parameter_list.at(i).llvm_val = (llvm_func->arg_begin() + offset + i);
   }
-  llvm_func = function;
-  logger->send_log("llvm_func: {}; function: {}", llvm_func != nullptr,
-                   function != nullptr);
-  return function;
 }
 
 void Function::generate_function_return(llvm::Value* return_override) {
@@ -104,17 +153,84 @@ void Function::generate_function_return(llvm::Value* return_override) {
   }
 
   Import<llvm::IRBuilder<>> builder;
-  if (noerr) {
-    builder->CreateRet(ret_val.get_llvm_val());
-  } else {
-    builder->CreateStore(ret_val.get_llvm_val(), llvm_func->arg_begin());
-    if (elut_ptr) {
-      auto tmp = builder->CreateLoad(builder->getPtrTy(), elut_ptr);
-      builder->CreateRet(tmp);
-    } else {
-      builder->CreateRet(llvm::ConstantPointerNull::get(builder->getPtrTy()));
+  bool is_void = return_type.get_yalll_type() == YALLLParser::VOID_T;
+  llvm::Value* err_id = err_id_ptr
+                            ? builder->CreateLoad(builder->getInt16Ty(),
+                                                  err_id_ptr, "err_id")
+                            : builder->getInt16(0);
+
+  switch (get_return_convention()) {
+    case ReturnConvention::Direct:
+      if (is_void)
+        builder->CreateRetVoid();
+      else
+        builder->CreateRet(ret_val.get_llvm_val());
+      break;
+    case ReturnConvention::Registers: {
+      if (is_void) {
+        builder->CreateRet(err_id);
+        break;
+      }
+      llvm::Value* result =
+          llvm::PoisonValue::get(llvm_func->getReturnType());
+      result = builder->CreateInsertValue(result, ret_val.get_llvm_val(), 0);
+      result = builder->CreateInsertValue(result, err_id, 1);
+      builder->CreateRet(result);
+      break;
     }
+    case ReturnConvention::ReturnPointer:
+      if (!is_void)
+        builder->CreateStore(ret_val.get_llvm_val(), llvm_func->arg_begin());
+      builder->CreateRet(err_id);
+      break;
+  }
+}
+
+void Function::generate_error_return(llvm::Value* err_id) {
+  Import<llvm::IRBuilder<>> builder;
+  bool is_void = return_type.get_yalll_type() == YALLLParser::VOID_T;
+
+  switch (get_return_convention()) {
+    case ReturnConvention::Direct:
+      if (is_entry_point()) {
+        // the process boundary, the message is printed and the program fails
+        builder->CreateCall(ELUT::get_report(*llvm_func->getParent()),
+                            {err_id});
+        builder->CreateRet(builder->getInt32(ELUT::ERROR_EXIT_STATUS));
+        break;
+      }
+      logger->send_internal_error("noerr function {} can't return an error",
+                                  get_llvm_name());
+      builder->CreateUnreachable();
+      break;
+    case ReturnConvention::Registers:
+      if (is_void) {
+        builder->CreateRet(err_id);
+        break;
+      }
+      builder->CreateRet(builder->CreateInsertValue(
+          llvm::Constant::getNullValue(llvm_func->getReturnType()), err_id,
+          1));
+      break;
+    case ReturnConvention::ReturnPointer:
+      builder->CreateRet(err_id);
+      break;
   }
 }
 
+ReturnConvention Function::get_return_convention() {
+  if (noerr) return ReturnConvention::Direct;
+
+  Import<yallc::CompilerOptions> options;
+  if (options->errable_abi == yallc::ErrableABI::ReturnPointer)
+    return ReturnConvention::ReturnPointer;
+
+  // {T, i16} only comes back in two registers if T fits into one
+  auto* type = return_type.get_llvm_type();
+  if (type->isVoidTy() ||
+      (type->isSingleValueType() && type->getPrimitiveSizeInBits() <= 64))
+    return ReturnConvention::Registers;
+  return ReturnConvention::ReturnPointer;
+}
+
 }  // namespace yalll
@@ -14,6 +14,16 @@
 
 namespace yalll {
 
+enum class ReturnConvention {
+  // noerr: T is returned like in any other language
+  Direct,
+  // errable: {T, error id} is returned in registers
+  Registers,
+  // errable: T is stored through the implicit retptr, only the error id is
+  // returned
+  ReturnPointer,
+};
+
 class Function {
  public:
   Function(std::string name, typesafety::TypeInformation return_type,
@@ -31,39 +41,64 @@ class Function {
       : name(other.name),
         return_type(other.return_type),
         ret_val(other.ret_val),
-        elut_ptr(other.elut_ptr),
+        err_id_ptr(other.err_id_ptr),
+        this_ptr(other.this_ptr),
         llvm_func(other.llvm_func),
         parameter_list(other.parameter_list),
-        noerr(other.noerr) {}
+        noerr(other.noerr),
+        owner(other.owner) {}
 
   Function(Function&& other)
       : name(other.name),
         return_type(other.return_type),
         ret_val(other.ret_val),
-        elut_ptr(other.elut_ptr),
+        err_id_ptr(other.err_id_ptr),
+        this_ptr(other.this_ptr),
         llvm_func(other.llvm_func),
         parameter_list(other.parameter_list),
-        noerr(other.noerr) {}
+        noerr(other.noerr),
+        owner(other.owner) {}
 
   Function& operator=(const Function& other);
   Function& operator=(Function&& other);
   ~Function() = default;
 
-  llvm::Function* generate_function_sig(llvm::Module& module);
+  // without body only the declaration is generated, the body can follow
+  // later using generate_function_body
+  llvm::Function* generate_function_sig(llvm::Module& module,
+                                        bool with_body = true);
+  void generate_function_body();
+  bool is_declaration() const { return llvm_func && llvm_func->empty(); }
   void generate_function_return(llvm::Value* return_override = nullptr);
+  // returns err_id to the caller, the return value is left zeroed
+  void generate_error_return(llvm::Value* err_id);
 
   std::vector<yalll::Value>& get_parameters() { return parameter_list; }
   std::string& get_name() { return name; }
   bool is_noerr() { return noerr; }
+  // main has no caller, errors escaping it end the program instead
+  bool is_entry_point() { return owner.empty() && name == "main"; }
+  bool can_return_errors() { return !noerr || is_entry_point(); }
+  ReturnConvention get_return_convention();
+
+  // methods get the object they are called on as implicit parameter
+  void make_method(const std::string& class_name) { owner = class_name; }
+  bool is_method() { return !owner.empty(); }
+  std::string& get_owner() { return owner; }
+  std::string get_llvm_name() {
+    return owner.empty() ? name : owner + "." + name;
+  }
 
   typesafety::TypeInformation& get_return_type() { return return_type; }
 
   Value ret_val;
-  llvm::Value* elut_ptr = nullptr;
+  llvm::Value* err_id_ptr = nullptr;
+  llvm::Value* this_ptr = nullptr;
   llvm::Function* llvm_func = nullptr;
 
  private:
   std::vector<llvm::Type*> param_list_to_type_list();
+  void bind_parameters();
 
   Import<util::Logger> logger;
 
@@ -71,5 +106,6 @@ class Function {
   typesafety::TypeInformation return_type;
   std::vector<yalll::Value> parameter_list;
   bool noerr;
+  std::string owner;
 };
 }  // namespace yalll
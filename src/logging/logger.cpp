@@ -7,18 +7,22 @@ void Logger::emit_msg() {
 
   switch (msg.type) {
     case LogType::Log:
-      std::cout << create_indent(msg.depth) << "[LOG]" << msg.msg << std::endl;
+      *out << create_indent(msg.depth) << "[LOG]" << msg.msg << std::endl;
+      break;
+    case LogType::Warning:
+      *err << create_indent(msg.depth) << "\033[35m[WRN]" << msg.msg
+                << "\033[0m" << std::endl;
       break;
     case LogType::Error:
-      std::cerr << create_indent(msg.depth) << "\033[31;44m[ERR]" << msg.msg
+      *err << create_indent(msg.depth) << "\033[31;44m[ERR]" << msg.msg
                 << "\033[0m" << std::endl;
       break;
     case LogType::Internal:
-      std::cerr << create_indent(msg.depth) << "\033[33m[INT]" << msg.msg
+      *err << create_indent(msg.depth) << "\033[33m[INT]" << msg.msg
                 << "\033[0m" << std::endl;
       break;
     default:
-      std::cout << "[UNKNOWN]" << msg.msg << std::endl;
+      *out << "[UNKNOWN]" << msg.msg << std::endl;
   }
   last_depth = msg.depth;
   log_queue.pop();
@@ -12,6 +12,7 @@ namespace util {
 
 enum class LogType {
   Log,
+  Warning,
   Error,
   Internal,
 };
@@ -24,6 +25,9 @@ struct LogMessage {
 
 class Logger {
  public:
+  Logger(std::ostream& out = std::cout, std::ostream& err = std::cerr)
+      : out(&out), err(&err) {}
+
   template <typename... Args>
   void send_log(std::string_view fmt, Args&&... args) {
     LogMessage msg{LogType::Log,
@@ -33,8 +37,20 @@ class Logger {
     emit_msg();
   }
 
+  template <typename... Args>
+  void send_warning(std::string_view fmt, Args&&... args) {
+    if (muted) return;
+    LogMessage msg{LogType::Warning,
+                   std::vformat(fmt, std::make_format_args(args...)),
+                   cur_depth};
+    log_queue.push(msg);
+    emit_msg();
+  }
+
   template <typename... Args>
   void send_error(std::string_view fmt, Args&&... args) {
+    if (muted) return;
+    ++error_count;
     LogMessage msg{LogType::Error,
                    std::vformat(fmt, std::make_format_args(args...)),
                    cur_depth};
@@ -44,6 +60,8 @@ class Logger {
 
   template <typename... Args>
   void send_internal_error(std::string_view fmt, Args&&... args) {
+    if (muted) return;
+    ++error_count;
     LogMessage msg{LogType::Internal,
                    std::vformat(fmt, std::make_format_args(args...)),
                    cur_depth};
@@ -56,15 +74,31 @@ class Logger {
   void operator+=(uint32_t add) { cur_depth += add; }
   void operator-=(uint32_t sub) { cur_depth -= sub; }
 
+  // errors and internal errors sent so far
+  size_t get_error_count() const { return error_count; }
+  // errors reported by someone else for the same compilation, i.e. a job
+  void add_errors(size_t count) { error_count += count; }
+  // while muted, warnings and errors are neither printed nor counted, i.e.
+  // the ones someone else reports for the same compilation
+  void set_muted(bool muted) { this->muted = muted; }
+
+  // logs go to out, everything else to err
+  std::ostream& get_out() { return *out; }
+  std::ostream& get_err() { return *err; }
+
   virtual void emit_msg();
   virtual void emit_all();
 
  protected:
   std::queue<LogMessage> log_queue;
-  uint32_t cur_depth;
+  uint32_t cur_depth = 0;
 
  private:
   uint32_t last_depth = 0;
+  size_t error_count = 0;
+  bool muted = false;
+  std::ostream* out;
+  std::ostream* err;
   std::string create_indent(uint32_t depth);
 };
 }  // namespace util
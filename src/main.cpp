@@ -1,5 +1,3 @@
-#include <ANTLRInputStream.h>
-#include <CommonTokenStream.h>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/ExecutionEngine/GenericValue.h>
 #include <llvm/IR/DerivedTypes.h>
@@ -7,47 +5,41 @@
 #include <llvm/IR/LLVMContext.h>
 #include <llvm/Support/raw_ostream.h>
 
-#include <fstream>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
 #include <iostream>
+#include <string>
+#include <thread>
 
-#include "YALLLLexer.h"
-#include "YALLLParser.h"
-#include "compiler/visitor_impl.h"
+#include "compiler/compilerinstance.h"
+#include "compiler/compileroptions.h"
+#include "compiler/incremental.h"
+#include "import/import.h"
 
-void load_test_prog(const char *arg_path = nullptr,
-                    const char *arg_out_path = nullptr) {
-  const char *path;
-  const char *out_path;
-  if (arg_path)
-    path = arg_path;
-  else
-    path = "../programs/floats.y";
+// --watch, compiles again whenever the file is written, reusing every
+// function that didn't change
+void watch_prog(yallc::CompilerInstance &compiler, const char *path,
+                const char *out_path) {
+  yallc::IncrementalCache cache;
+  std::filesystem::file_time_type last_write;
+  while (true) {
+    std::error_code ec;
+    auto write_time = std::filesystem::last_write_time(path, ec);
+    if (!ec && write_time != last_write) {
+      last_write = write_time;
 
-  if (arg_out_path)
-    out_path = arg_out_path;
-  else
-    out_path = "../output.ll";
-
-  std::cout << "Loading: " << path << std::endl;
-
-  std::ifstream stream(path);
-  if (!stream.good()) {
-    std::cout << "Bad path, aborting!" << std::endl;
-    return;
+      auto start = std::chrono::steady_clock::now();
+      (void)compiler.compile(path, out_path, &cache);
+      auto time = std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::steady_clock::now() - start);
+      std::cout << "Compiled in " << time.count() << " ms, reused "
+                << cache.get_reused_count() << " functions" << std::endl;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
   }
-
-  antlr4::ANTLRInputStream input(stream);
-  YALLLLexer lexer(&input);
-  antlr4::CommonTokenStream tokens(&lexer);
-  YALLLParser parser(&tokens);
-
-  auto ast = parser.program();
-  std::cout << ast->getText() << std::endl;
-
-  yallc::YALLLVisitorImpl visitor(out_path);
-  visitor.visit(ast);
-
-  stream.close();
 }
 
 char *get_cmd_option(char **begin, char **end, const std::string &option) {
@@ -62,9 +54,142 @@ bool cmd_option_exists(char **begin, char **end, const std::string &option) {
   return std::find(begin, end, option) != end;
 }
 
+// --option=value
+const char *get_cmd_value(char **begin, char **end,
+                          const std::string &option) {
+  auto prefix = option + "=";
+  for (auto itr = begin; itr != end; ++itr) {
+    if (std::string(*itr).starts_with(prefix)) return *itr + prefix.size();
+  }
+  return nullptr;
+}
+
+// the whole value has to be a number, false otherwise
+bool parse_number(const char *value, unsigned long &number) {
+  auto end = value + std::strlen(value);
+  auto [ptr, ec] = std::from_chars(value, end, number);
+  return ec == std::errc() && ptr == end && ptr != value;
+}
+
+bool parse_compiler_options(char **begin, char **end) {
+  yalll::Import<yallc::CompilerOptions> options;
+
+  if (auto *abi = get_cmd_value(begin, end, "--errable-abi")) {
+    if (std::string(abi) == "registers") {
+      options->errable_abi = yallc::ErrableABI::Registers;
+    } else if (std::string(abi) == "retptr") {
+      options->errable_abi = yallc::ErrableABI::ReturnPointer;
+    } else {
+      std::cout << "Unknown errable abi " << abi
+                << ", expected registers or retptr" << std::endl;
+      return false;
+    }
+  }
+
+  // --stack-size=<MiB>
+  if (auto *size = get_cmd_value(begin, end, "--stack-size")) {
+    unsigned long mib = 0;
+    if (!parse_number(size, mib) || mib == 0 || mib >= 4096) {
+      std::cout << "Stack size has to be between 1 and 4095 MiB" << std::endl;
+      return false;
+    }
+    options->stack_size = mib << 20;
+  }
+
+  // --jobs uses every core, --jobs=<n> n threads
+  if (cmd_option_exists(begin, end, "--jobs")) {
+    options->jobs = std::max(1u, std::thread::hardware_concurrency());
+  }
+  if (auto *jobs = get_cmd_value(begin, end, "--jobs")) {
+    unsigned long count = 0;
+    if (!parse_number(jobs, count) || count == 0 || count > 256) {
+      std::cout << "Jobs have to be between 1 and 256" << std::endl;
+      return false;
+    }
+    options->jobs = count;
+  }
+
+  if (cmd_option_exists(begin, end, "--no-infer-noerr")) {
+    options->infer_noerr = false;
+  }
+  if (cmd_option_exists(begin, end, "--no-infer-effects")) {
+    options->infer_effects = false;
+  }
+
+  for (auto itr = begin; itr != end; ++itr) {
+    auto arg = std::string(*itr);
+    if (arg.size() == 3 && arg.starts_with("-O") && arg[2] >= '0' &&
+        arg[2] <= '3') {
+      options->opt_level = arg[2] - '0';
+    }
+  }
+
+  if (cmd_option_exists(begin, end, "--whole-program")) {
+    options->whole_program = true;
+  }
+  if (cmd_option_exists(begin, end, "--reachable-only")) {
+    options->reachable_only = true;
+  }
+
+  if (cmd_option_exists(begin, end, "--parse-profile")) {
+    options->parse_profile = true;
+  }
+  if (cmd_option_exists(begin, end, "--stream")) {
+    options->stream = true;
+  }
+  // streaming never sees the whole program
+  if (options->stream && options->reachable_only) {
+    std::cout << "--stream and --reachable-only can't be combined"
+              << std::endl;
+    return false;
+  }
+
+  if (cmd_option_exists(begin, end, "-g")) {
+    options->debug_info = true;
+  }
+  if (cmd_option_exists(begin, end, "--frame-pointer")) {
+    options->frame_pointer = true;
+  }
+
+  if (auto *cpu = get_cmd_value(begin, end, "--target-cpu")) {
+    options->target_cpu = cpu;
+  }
+  if (auto *features = get_cmd_value(begin, end, "--target-features")) {
+    options->target_features = features;
+  }
+
+  if (cmd_option_exists(begin, end, "--fast-math")) {
+    options->fast_math = "fast";
+  }
+  if (auto *flags = get_cmd_value(begin, end, "--fast-math")) {
+    options->fast_math = flags;
+  }
+
+  if (cmd_option_exists(begin, end, "--profile-generate")) {
+    options->profile_generate = true;
+  }
+  if (auto *path = get_cmd_value(begin, end, "--profile-generate")) {
+    options->profile_generate = true;
+    options->profile_generate_path = path;
+  }
+  if (auto *path = get_cmd_value(begin, end, "--profile-use")) {
+    options->profile_use = path;
+  }
+  if (options->profile_generate && !options->profile_use.empty()) {
+    std::cout << "--profile-generate and --profile-use can't be combined"
+              << std::endl;
+    return false;
+  }
+  // a profile is useless without optimizations
+  if (!options->profile_use.empty() && options->opt_level == 0) {
+    options->opt_level = 2;
+  }
+  return true;
+}
+
 int main(int argc, char *argv[]) {
-  char *arg_file;
-  char *arg_out_path;
+  char *arg_file = nullptr;
+  char *arg_out_path = nullptr;
   if (cmd_option_exists(argv, argv + argc, "-f")) {
     arg_file = get_cmd_option(argv, argv + argc, "-f");
   }
@@ -73,6 +198,32 @@ int main(int argc, char *argv[]) {
     arg_out_path = get_cmd_option(argv, argv + argc, "-o");
   }
 
-  load_test_prog(arg_file, arg_out_path);
-  return 0;
+  if (!parse_compiler_options(argv, argv + argc)) return 1;
+
+  yalll::Import<yallc::CompilerOptions> options;
+  bool watch = cmd_option_exists(argv, argv + argc, "--watch");
+  if (watch && !arg_file) {
+    std::cout << "--watch needs a file to watch (-f)" << std::endl;
+    return 1;
+  }
+  if (options->stream && !arg_file) {
+    std::cout << "--stream needs a file to stream (-f)" << std::endl;
+    return 1;
+  }
+  // the cache keeps the source of every function around
+  if (options->stream && watch) {
+    std::cout << "--stream and --watch can't be combined" << std::endl;
+    return 1;
+  }
+
+  // the options were parsed into the default context of this thread, the
+  // compiler gets its own copy
+  yallc::CompilerInstance compiler(*options);
+  const char *path = arg_file ? arg_file : "../programs/floats.y";
+  const char *out_path = arg_out_path ? arg_out_path : "../output.ll";
+  if (watch) {
+    watch_prog(compiler, path, out_path);
+    return 0;
+  }
+  return compiler.compile(path, out_path) ? 0 : 1;
 }
@@ -14,6 +14,7 @@ Value AddOperation::generate_value() {
 
   for (auto i = 0; i < op_codes.size(); ++i) {
     auto rhs = operations[i + 1]->generate_value();
+    match_vector_operands(lhs, rhs);
     switch (op_codes[i]) {
       case YALLLParser::PLUS_SYM:
         if (float_mode) {
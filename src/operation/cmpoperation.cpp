@@ -7,109 +7,125 @@
 namespace yalll {
 
 Value CmpOperation::generate_value() {
+  if (lanes) return generate_vector_compare();
+
   Value lhs = operations.at(0)->generate_value();
   bool float_mode = lhs.type_info.is_float_type();
   bool signed_mode = lhs.type_info.is_signed();
 
-  std::vector<llvm::Value*> cmps;
+  // a < b < c is a < b && b < c, every operand is evaluated at most once
+  auto* result = generate_short_circuit(
+      true, op_codes.size(),
+      [&](size_t i) {
+        auto rhs = operations.at(i + 1)->generate_value();
+        auto* cmp =
+            generate_compare(op_codes.at(i), lhs, rhs, float_mode, signed_mode);
+        lhs = rhs;
+        return cmp;
+      },
+      [&](size_t i) { return operations.at(i + 1)->is_speculatable(); });
+
+  Value value(typesafety::TypeInformation::BOOL_T(), result, lhs.get_line());
+  logger->send_log("GenCmp: {}", value.to_string());
+  return std::move(value);
+}
 
+Value CmpOperation::generate_vector_compare() {
   yalll::Import<llvm::IRBuilder<>> builder;
+  Value lhs = operations.at(0)->generate_value();
+  bool float_mode = lhs.type_info.is_float_type();
+  bool signed_mode = lhs.type_info.is_signed();
+
+  // there is nothing to short circuit, a < b < c is (a < b) & (b < c) for
+  // every lane
+  llvm::Value* mask = nullptr;
   for (auto i = 0; i < op_codes.size(); ++i) {
-    auto rhs = operations[i + 1]->generate_value();
+    auto rhs = operations.at(i + 1)->generate_value();
+    match_vector_operands(lhs, rhs);
+    auto* cmp =
+        generate_compare(op_codes.at(i), lhs, rhs, float_mode, signed_mode);
+    mask = mask ? builder->CreateAnd(mask, cmp) : cmp;
+    lhs = rhs;
+  }
 
-    switch (op_codes[i]) {
-      case YALLLParser::GREATER_SYM:
-        if (float_mode) {
-          cmps.push_back(
-              builder->CreateFCmpUGT(lhs.get_llvm_val(), rhs.get_llvm_val()));
-        } else {
-          if (signed_mode) {
-            cmps.push_back(
-                builder->CreateICmpSGT(lhs.get_llvm_val(), rhs.get_llvm_val()));
-          } else {
-            cmps.push_back(
-                builder->CreateICmpUGT(lhs.get_llvm_val(), rhs.get_llvm_val()));
-          }
-        }
-        break;
-      case YALLLParser::GREATER_EQUAL_SYM:
-        if (float_mode) {
-          cmps.push_back(
-              builder->CreateFCmpUGE(lhs.get_llvm_val(), rhs.get_llvm_val()));
-        } else {
-          if (signed_mode) {
-            cmps.push_back(
-                builder->CreateICmpSGE(lhs.get_llvm_val(), rhs.get_llvm_val()));
-          } else {
-            cmps.push_back(
-                builder->CreateICmpUGE(lhs.get_llvm_val(), rhs.get_llvm_val()));
-          }
-        }
-        break;
-      case YALLLParser::LESS_SYM:
-        if (float_mode) {
-          cmps.push_back(
-              builder->CreateFCmpULT(lhs.get_llvm_val(), rhs.get_llvm_val()));
+  Value value(typesafety::TypeInformation::VEC_T(
+                  typesafety::TypeInformation::BOOL_T(), lanes),
+              mask, lhs.get_line());
+  logger->send_log("GenCmp: {}", value.to_string());
+  return std::move(value);
+}
+
+llvm::Value* CmpOperation::generate_compare(size_t op_code, Value& lhs,
+                                            Value& rhs, bool float_mode,
+                                            bool signed_mode) {
+  yalll::Import<llvm::IRBuilder<>> builder;
+  // compares are unordered, a NaN makes them true. If fast math excludes NaNs
+  // both are the same and the ordered ones fold into min / max more easily.
+  bool ordered = builder->getFastMathFlags().noNaNs();
+  auto fcmp = [&](llvm::CmpInst::Predicate ordered_predicate,
+                  llvm::CmpInst::Predicate unordered_predicate) {
+    return builder->CreateFCmp(
+        ordered ? ordered_predicate : unordered_predicate,
+        lhs.get_llvm_val(), rhs.get_llvm_val());
+  };
+
+  switch (op_code) {
+    case YALLLParser::GREATER_SYM:
+      if (float_mode) {
+        return fcmp(llvm::CmpInst::FCMP_OGT, llvm::CmpInst::FCMP_UGT);
+      } else {
+        if (signed_mode) {
+          return builder->CreateICmpSGT(lhs.get_llvm_val(), rhs.get_llvm_val());
         } else {
-          if (signed_mode) {
-            cmps.push_back(
-                builder->CreateICmpSLT(lhs.get_llvm_val(), rhs.get_llvm_val()));
-          } else {
-            cmps.push_back(
-                builder->CreateICmpULT(lhs.get_llvm_val(), rhs.get_llvm_val()));
-          }
+          return builder->CreateICmpUGT(lhs.get_llvm_val(), rhs.get_llvm_val());
         }
-        break;
-      case YALLLParser::LESS_EQUAL_SYM:
-        if (float_mode) {
-          cmps.push_back(
-              builder->CreateFCmpULE(lhs.get_llvm_val(), rhs.get_llvm_val()));
+      }
+    case YALLLParser::GREATER_EQUAL_SYM:
+      if (float_mode) {
+        return fcmp(llvm::CmpInst::FCMP_OGE, llvm::CmpInst::FCMP_UGE);
+      } else {
+        if (signed_mode) {
+          return builder->CreateICmpSGE(lhs.get_llvm_val(), rhs.get_llvm_val());
         } else {
-          if (signed_mode) {
-            cmps.push_back(
-                builder->CreateICmpSLE(lhs.get_llvm_val(), rhs.get_llvm_val()));
-          } else {
-            cmps.push_back(
-                builder->CreateICmpULE(lhs.get_llvm_val(), rhs.get_llvm_val()));
-          }
+          return builder->CreateICmpUGE(lhs.get_llvm_val(), rhs.get_llvm_val());
         }
-        break;
-      case YALLLParser::EQUAL_EQUAL_SYM:
-        if (float_mode) {
-          cmps.push_back(
-              builder->CreateFCmpUEQ(lhs.get_llvm_val(), rhs.get_llvm_val()));
+      }
+    case YALLLParser::LESS_SYM:
+      if (float_mode) {
+        return fcmp(llvm::CmpInst::FCMP_OLT, llvm::CmpInst::FCMP_ULT);
+      } else {
+        if (signed_mode) {
+          return builder->CreateICmpSLT(lhs.get_llvm_val(), rhs.get_llvm_val());
         } else {
-          cmps.push_back(
-              builder->CreateICmpEQ(lhs.get_llvm_val(), rhs.get_llvm_val()));
+          return builder->CreateICmpULT(lhs.get_llvm_val(), rhs.get_llvm_val());
         }
-        break;
-      case YALLLParser::NOT_EQUAL_SYM:
-        if (float_mode) {
-          cmps.push_back(
-              builder->CreateFCmpUNE(lhs.get_llvm_val(), rhs.get_llvm_val()));
+      }
+    case YALLLParser::LESS_EQUAL_SYM:
+      if (float_mode) {
+        return fcmp(llvm::CmpInst::FCMP_OLE, llvm::CmpInst::FCMP_ULE);
+      } else {
+        if (signed_mode) {
+          return builder->CreateICmpSLE(lhs.get_llvm_val(), rhs.get_llvm_val());
         } else {
-          cmps.push_back(
-              builder->CreateICmpNE(lhs.get_llvm_val(), rhs.get_llvm_val()));
+          return builder->CreateICmpULE(lhs.get_llvm_val(), rhs.get_llvm_val());
         }
-        break;
-    }
-
-    lhs = rhs;
+      }
+    case YALLLParser::EQUAL_EQUAL_SYM:
+      if (float_mode) {
+        return fcmp(llvm::CmpInst::FCMP_OEQ, llvm::CmpInst::FCMP_UEQ);
+      } else {
+        return builder->CreateICmpEQ(lhs.get_llvm_val(), rhs.get_llvm_val());
+      }
+    case YALLLParser::NOT_EQUAL_SYM:
+      if (float_mode) {
+        return fcmp(llvm::CmpInst::FCMP_ONE, llvm::CmpInst::FCMP_UNE);
+      } else {
+        return builder->CreateICmpNE(lhs.get_llvm_val(), rhs.get_llvm_val());
+      }
   }
 
-  Value result(typesafety::TypeInformation::BOOL_T(), cmps.at(0),
-               lhs.get_line());
-  if (cmps.size() > 1) {
-    for (auto* cmp : std::vector<llvm::Value*>(cmps.begin() + 1, cmps.end())) {
-      result = Value(result.type_info,
-                     builder->CreateAnd(result.get_llvm_val(), cmp),
-                     result.get_line());
-    }
-  }
-
-
-  logger->send_log("GenCmp: {}", lhs.to_string());
-  return std::move(result);
+  logger->send_internal_error("Unknown compare operator {}", op_code);
+  return nullptr;
 }
 
 std::vector<typesafety::TypeProposal>
@@ -120,11 +136,17 @@ CmpOperation::gather_and_resolve_proposals() {
     proposals.insert(proposals.end(), tmp.begin(), tmp.end());
   }
 
-  if (typesafety::TypeResolver::try_resolve(proposals))
+  if (typesafety::TypeResolver::try_resolve(proposals)) {
+    for (auto& proposal : proposals) {
+      if (typesafety::is_vector_yalll_t(proposal.yalll_type))
+        lanes = typesafety::vector_lanes(proposal.yalll_type);
+    }
+    auto result = lanes ? typesafety::vector_yalll_t(YALLLParser::BOOL_T, lanes)
+                        : static_cast<size_t>(YALLLParser::BOOL_T);
     return std::move(std::vector<typesafety::TypeProposal>{
-        typesafety::TypeProposal{YALLLParser::BOOL_T, true, nullptr}});
-  else
-    return std::move(std::vector<typesafety::TypeProposal>{});
+        typesafety::TypeProposal{result, true, nullptr}});
+  }
+  return std::move(std::vector<typesafety::TypeProposal>{});
 }
 
 }  // namespace yalll
@@ -12,5 +12,14 @@ class CmpOperation : public Operation {
   using Operation::Operation;
   Value generate_value() override;
   std::vector<typesafety::TypeProposal> gather_and_resolve_proposals() override;
+
+ private:
+  llvm::Value* generate_compare(size_t op_code, Value& lhs, Value& rhs,
+                                bool float_mode, bool signed_mode);
+  // compares every lane, the result is a mask
+  Value generate_vector_compare();
+
+  // lanes of the compared vectors, 0 for scalars
+  size_t lanes = 0;
 };
 }  // namespace yalll
@@ -1,47 +1,185 @@
 #include "funccalloperation.h"
 
+#include <llvm/IR/MDBuilder.h>
+
 #include <vector>
 
 namespace yalll {
 
 Value FuncCallOperation::generate_value() {
   logger->send_log("Generating function call for {}", func.get_name());
-  if (func.is_noerr()) {
-    std::vector<llvm::Value*> arguments;
-
-    for (auto op : operations) {
-      arguments.push_back(op->generate_value().get_llvm_val());
-    }
+  auto convention = func.get_return_convention();
+  auto& return_type = func.get_return_type();
+  bool is_void = return_type.get_yalll_type() == YALLLParser::VOID_T;
 
-    return std::move(Value(func.get_return_type(), func.ret_val.get_llvm_val(),
-                           func.ret_val.get_line()));
+  llvm::AllocaInst* retvalptr = nullptr;
+  if (convention == ReturnConvention::ReturnPointer) {
+    retvalptr = create_entry_alloca(is_void ? builder->getInt8Ty()
+                                            : return_type.get_llvm_type(),
+                                    "retvalptr");
+  }
+  auto arguments = generate_arguments(retvalptr);
+  auto* call = emit_call(arguments);
 
-  } else {
-    auto retvalptr = builder->CreateAlloca(func.get_return_type().get_llvm_type(), nullptr, "retvalptr");
-    std::vector<llvm::Value*> arguments{retvalptr};
+  llvm::Value* retval = nullptr;
+  llvm::Value* err_id = nullptr;
+  switch (convention) {
+    case ReturnConvention::Direct:
+      retval = call;
+      break;
+    case ReturnConvention::Registers:
+      if (is_void) {
+        err_id = call;
+      } else {
+        retval = builder->CreateExtractValue(call, 0, "retval");
+        err_id = builder->CreateExtractValue(call, 1, "err_id");
+      }
+      break;
+    case ReturnConvention::ReturnPointer:
+      if (!is_void) {
+        retval = builder->CreateLoad(return_type.get_llvm_type(), retvalptr,
+                                     "retval");
+      }
+      err_id = call;
+      break;
+  }
 
-    for (auto op : operations) {
-      arguments.push_back(op->generate_value().get_llvm_val());
-    }
+  if (caller && err_id) generate_propagation(err_id);
 
-    builder->CreateCall(func.llvm_func,
-                        llvm::ArrayRef<llvm::Value*>{arguments});
-    auto retval = builder->CreateLoad(func.get_return_type().get_llvm_type(), retvalptr);
-    return std::move(Value(func.get_return_type(), retval, func.ret_val.get_line()));
-  }
+  auto value = Value(return_type, retval, func.ret_val.get_line());
+  value.err_id = err_id;
+  return std::move(value);
 }
 
 std::vector<typesafety::TypeProposal>
 FuncCallOperation::gather_and_resolve_proposals() {
-  std::vector<typesafety::TypeProposal> proposals;
-  for (auto op : operations) {
-    auto tmp = op->gather_and_resolve_proposals();
-    proposals.insert(proposals.end(), tmp.begin(), tmp.end());
+  // every argument resolves to the type of the parameter it is passed as
+  auto& parameters = func.get_parameters();
+  for (auto i = 0; i < operations.size(); ++i) {
+    auto proposals = operations.at(i)->gather_and_resolve_proposals();
+    if (i >= parameters.size()) {
+      logger->send_error("Too many arguments for {}, expected {}",
+                         func.get_name(), parameters.size());
+      break;
+    }
+    (void)typesafety::TypeResolver::try_resolve_to_type(
+        proposals, parameters.at(i).type_info);
+  }
+  if (operations.size() < parameters.size()) {
+    logger->send_error("Too few arguments for {}, expected {}",
+                       func.get_name(), parameters.size());
   }
-  (void)typesafety::TypeResolver::try_resolve_to_type(proposals,
-                                                      func.get_return_type());
   return std::move(
       std::vector<typesafety::TypeProposal>{typesafety::TypeProposal{
           func.get_return_type().get_yalll_type(), true, nullptr}});
 }
+
+std::string FuncCallOperation::generate_tail_call(Function& caller) {
+  // the callee has to hand back exactly what the caller returns
+  if (func.get_return_convention() != caller.get_return_convention() ||
+      func.llvm_func->getReturnType() !=
+          caller.llvm_func->getReturnType() ||
+      func.get_return_type().get_llvm_type() !=
+          caller.get_return_type().get_llvm_type()) {
+    return "caller and callee return different types";
+  }
+
+  // objects may live in the stack frame, that is reused by the tail call
+  for (auto& parameter : func.get_parameters()) {
+    if (parameter.type_info.is_object()) {
+      return "object " + parameter.name + " may live in the caller's frame";
+    }
+  }
+
+  // musttail needs identical prototypes, tailcc guarantees the tail call for
+  // any prototype
+  auto kind = llvm::CallInst::TCK_MustTail;
+  if (func.llvm_func->getFunctionType() !=
+          caller.llvm_func->getFunctionType() ||
+      func.llvm_func->getCallingConv() != caller.llvm_func->getCallingConv()) {
+    if (func.llvm_func->getCallingConv() != llvm::CallingConv::Tail ||
+        caller.llvm_func->getCallingConv() != llvm::CallingConv::Tail) {
+      return "signatures differ and caller and callee aren't recursive";
+    }
+    kind = llvm::CallInst::TCK_Tail;
+  }
+
+  logger->send_log("Generating tail call from {} to {}",
+                   caller.get_llvm_name(), func.get_llvm_name());
+
+  // the caller's return pointer is passed on, the callee writes directly
+  // into the frame of our caller
+  llvm::Value* retptr = nullptr;
+  if (func.get_return_convention() == ReturnConvention::ReturnPointer) {
+    retptr = caller.llvm_func->arg_begin();
+  }
+  auto arguments = generate_arguments(retptr);
+  auto* call = emit_call(arguments);
+  call->setTailCallKind(kind);
+
+  if (call->getType()->isVoidTy())
+    builder->CreateRetVoid();
+  else
+    builder->CreateRet(call);
+  return "";
+}
+
+std::vector<llvm::Value*> FuncCallOperation::generate_arguments(
+    llvm::Value* retptr) {
+  std::vector<llvm::Value*> arguments;
+  if (retptr) arguments.push_back(retptr);
+  if (func.is_method()) {
+    if (!this_ptr) {
+      logger->send_internal_error("Method {} called without an object",
+                                  func.get_llvm_name());
+    }
+    arguments.push_back(this_ptr);
+  }
+
+  for (auto op : operations) {
+    arguments.push_back(op->generate_value().get_llvm_val());
+  }
+  return std::move(arguments);
+}
+
+llvm::CallInst* FuncCallOperation::emit_call(
+    std::vector<llvm::Value*>& arguments) {
+  auto* call = builder->CreateCall(func.llvm_func,
+                                   llvm::ArrayRef<llvm::Value*>{arguments});
+  call->setCallingConv(func.llvm_func->getCallingConv());
+  return call;
+}
+
+void FuncCallOperation::generate_propagation(llvm::Value* err_id) {
+  if (!caller->can_return_errors()) {
+    logger->send_internal_error("Errors of {} escape from noerr function {}",
+                                func.get_llvm_name(), caller->get_llvm_name());
+    return;
+  }
+
+  auto* function = builder->GetInsertBlock()->getParent();
+  auto* propagate =
+      llvm::BasicBlock::Create(builder->getContext(), "propagate", function);
+  auto* no_error =
+      llvm::BasicBlock::Create(builder->getContext(), "no_error", function);
+
+  // errors are the exception, the check is laid out as fall through
+  llvm::MDBuilder md_builder(builder->getContext());
+  builder->CreateCondBr(builder->CreateICmpNE(err_id, builder->getInt16(0)),
+                        propagate, no_error,
+                        md_builder.createBranchWeights(1, 2000));
+
+  builder->SetInsertPoint(propagate);
+  caller->generate_error_return(err_id);
+  builder->SetInsertPoint(no_error);
+}
+
+llvm::AllocaInst* FuncCallOperation::create_entry_alloca(
+    llvm::Type* type, const std::string& name) {
+  // allocas outside of the entry block grow the stack on every call in a loop
+  auto* function = builder->GetInsertBlock()->getParent();
+  auto& entry = function->getEntryBlock();
+  llvm::IRBuilder<> entry_builder(&entry, entry.getFirstInsertionPt());
+  return entry_builder.CreateAlloca(type, nullptr, name);
+}
 }  // namespace yalll
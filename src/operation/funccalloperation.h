@@ -1,7 +1,9 @@
 #pragma once
 
 #include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Instructions.h>
 
+#include <string>
 #include <vector>
 
 #include "../function/function.h"
@@ -13,13 +15,39 @@ class FuncCallOperation : public Operation {
  public:
   using Operation::Operation;
   explicit FuncCallOperation(Function& func,
-                             std::vector<std::shared_ptr<Operation>> operations)
-      : func(func), Operation(operations, std::vector<size_t>()) {}
+                             std::vector<std::shared_ptr<Operation>> operations,
+                             llvm::Value* this_ptr = nullptr)
+      : func(func),
+        this_ptr(this_ptr),
+        Operation(operations, std::vector<size_t>()) {}
   Value generate_value() override;
   std::vector<typesafety::TypeProposal> gather_and_resolve_proposals() override;
+  bool is_speculatable() override { return false; }
+
+  // generates `return func(...)` of caller as guaranteed tail call, returns
+  // why that isn't possible otherwise, without generating anything
+  std::string generate_tail_call(Function& caller);
+
+  // errors of the call that aren't handled are returned from caller right
+  // after the call, without this the error id is only passed on in the value
+  void propagate_errors_to(Function& caller) { this->caller = &caller; }
+
+  // @tailcall
+  void require_tail_call() { tail_call_required = true; }
+  bool is_tail_call_required() const { return tail_call_required; }
+  Function& get_function() { return func; }
 
  private:
+  std::vector<llvm::Value*> generate_arguments(llvm::Value* retptr);
+  llvm::CallInst* emit_call(std::vector<llvm::Value*>& arguments);
+  void generate_propagation(llvm::Value* err_id);
+  llvm::AllocaInst* create_entry_alloca(llvm::Type* type,
+                                        const std::string& name);
+
   Function& func;
+  llvm::Value* this_ptr;
+  Function* caller = nullptr;
+  bool tail_call_required = false;
   Import<llvm::IRBuilder<>> builder;
 };
 }  // namespace yalll
@@ -0,0 +1,242 @@
+#include "intrinsicoperation.h"
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/Intrinsics.h>
+
+#include <map>
+#include <vector>
+
+namespace yalll {
+
+std::optional<IntrinsicOperation::Kind> IntrinsicOperation::from_name(
+    const std::string& name) {
+  static const std::map<std::string, Kind> builtins = {
+      {"expect", Kind::Expect},       {"popcount", Kind::Popcount},
+      {"clz", Kind::CountLeading},    {"ctz", Kind::CountTrailing},
+      {"bswap", Kind::ByteSwap},      {"rotl", Kind::RotateLeft},
+      {"rotr", Kind::RotateRight},    {"fma", Kind::Fma},
+      {"sqrt", Kind::Sqrt},           {"min", Kind::Min},
+      {"max", Kind::Max},             {"abs", Kind::Abs},
+      {"prefetch", Kind::Prefetch},   {"cycle_counter", Kind::CycleCounter}};
+  if (!builtins.contains(name)) return std::nullopt;
+  return builtins.at(name);
+}
+
+size_t IntrinsicOperation::operand_count(Kind kind) {
+  switch (kind) {
+    case Kind::CycleCounter:
+      return 0;
+    case Kind::Expect:
+    case Kind::RotateLeft:
+    case Kind::RotateRight:
+    case Kind::Min:
+    case Kind::Max:
+      return 2;
+    case Kind::Fma:
+      return 3;
+    default:
+      return 1;
+  }
+}
+
+Value IntrinsicOperation::generate_value() {
+  if (!resolved) {
+    return Value(typesafety::TypeInformation::VOID_T(),
+                 llvm::PoisonValue::get(builder->getVoidTy()), line);
+  }
+
+  std::vector<llvm::Value*> values;
+  for (auto op : operations) {
+    values.push_back(op->generate_value().get_llvm_val());
+  }
+
+  auto* type = operand_type.get_llvm_type();
+  bool float_mode = kind != Kind::CycleCounter && operand_type.is_float_type();
+  llvm::Value* result = nullptr;
+  switch (kind) {
+    case Kind::Expect:
+      if (!llvm::isa<llvm::ConstantInt>(values.at(1))) {
+        logger->send_error("expect in line {} needs a constant to expect",
+                           line);
+        result = values.at(0);
+        break;
+      }
+      result = builder->CreateIntrinsic(llvm::Intrinsic::expect, {type},
+                                        values);
+      break;
+    case Kind::Popcount:
+      result = builder->CreateUnaryIntrinsic(llvm::Intrinsic::ctpop,
+                                             values.at(0));
+      break;
+    // 0 isn't poison, it has as many leading and trailing zeros as bits
+    case Kind::CountLeading:
+      result = builder->CreateBinaryIntrinsic(llvm::Intrinsic::ctlz,
+                                              values.at(0),
+                                              builder->getFalse());
+      break;
+    case Kind::CountTrailing:
+      result = builder->CreateBinaryIntrinsic(llvm::Intrinsic::cttz,
+                                              values.at(0),
+                                              builder->getFalse());
+      break;
+    case Kind::ByteSwap:
+      result = builder->CreateUnaryIntrinsic(llvm::Intrinsic::bswap,
+                                             values.at(0));
+      break;
+    // a rotate is a funnel shift of a value with itself
+    case Kind::RotateLeft:
+      result = builder->CreateIntrinsic(
+          llvm::Intrinsic::fshl, {type},
+          {values.at(0), values.at(0), values.at(1)});
+      break;
+    case Kind::RotateRight:
+      result = builder->CreateIntrinsic(
+          llvm::Intrinsic::fshr, {type},
+          {values.at(0), values.at(0), values.at(1)});
+      break;
+    case Kind::Fma:
+      result = builder->CreateIntrinsic(llvm::Intrinsic::fma, {type}, values);
+      break;
+    case Kind::Sqrt:
+      result = builder->CreateUnaryIntrinsic(llvm::Intrinsic::sqrt,
+                                             values.at(0));
+      break;
+    case Kind::Min:
+      result = builder->CreateBinaryIntrinsic(
+          float_mode                 ? llvm::Intrinsic::minnum
+          : operand_type.is_signed() ? llvm::Intrinsic::smin
+                                     : llvm::Intrinsic::umin,
+          values.at(0), values.at(1));
+      break;
+    case Kind::Max:
+      result = builder->CreateBinaryIntrinsic(
+          float_mode                 ? llvm::Intrinsic::maxnum
+          : operand_type.is_signed() ? llvm::Intrinsic::smax
+                                     : llvm::Intrinsic::umax,
+          values.at(0), values.at(1));
+      break;
+    case Kind::Abs:
+      if (float_mode) {
+        result = builder->CreateUnaryIntrinsic(llvm::Intrinsic::fabs,
+                                               values.at(0));
+      } else if (operand_type.is_signed()) {
+        // abs of the smallest value wraps around to itself
+        result = builder->CreateBinaryIntrinsic(
+            llvm::Intrinsic::abs, values.at(0), builder->getFalse());
+      } else {
+        result = values.at(0);
+      }
+      break;
+    // read access with high locality into the data cache
+    case Kind::Prefetch:
+      result = builder->CreateIntrinsic(
+          llvm::Intrinsic::prefetch, {type},
+          {values.at(0), builder->getInt32(0), builder->getInt32(3),
+           builder->getInt32(1)});
+      break;
+    case Kind::CycleCounter:
+      result =
+          builder->CreateIntrinsic(llvm::Intrinsic::readcyclecounter, {}, {});
+      break;
+  }
+
+  Value value(result_type, result, line);
+  logger->send_log("GenIntrinsic: {}", value.to_string());
+  return std::move(value);
+}
+
+std::vector<typesafety::TypeProposal>
+IntrinsicOperation::gather_and_resolve_proposals() {
+  // every operand of an intrinsic has the same type, rotl(x, 3) rotates by a
+  // 3 of the type of x
+  std::vector<typesafety::TypeProposal> proposals;
+  for (auto op : operations) {
+    auto tmp = op->gather_and_resolve_proposals();
+    proposals.insert(proposals.end(), tmp.begin(), tmp.end());
+  }
+
+  if (kind == Kind::CycleCounter) {
+    result_type = typesafety::TypeInformation::U64_T();
+    resolved = true;
+    return std::vector<typesafety::TypeProposal>{typesafety::TypeProposal{
+        result_type.get_yalll_type(), true, nullptr}};
+  }
+
+  // objects aren't resolved, they already have their type
+  bool resolved_operands =
+      !proposals.empty() &&
+      (kind == Kind::Prefetch ||
+       typesafety::TypeResolver::try_resolve(proposals));
+  if (!resolved_operands) {
+    logger->send_error("Operands of {} in line {} don't have a common type",
+                       name, line);
+    return std::vector<typesafety::TypeProposal>();
+  }
+
+  operand_type = resolved_type(proposals.front());
+  resolved = resolve_result_type(operand_type);
+  // prefetch only exists for its side effect
+  if (!resolved || kind == Kind::Prefetch)
+    return std::vector<typesafety::TypeProposal>();
+  return std::vector<typesafety::TypeProposal>{typesafety::TypeProposal{
+      result_type.get_yalll_type(), true, nullptr}};
+}
+
+bool IntrinsicOperation::resolve_result_type(
+    typesafety::TypeInformation& operand_type) {
+  auto element = operand_type.is_vector() ? operand_type.get_element_type()
+                                          : operand_type;
+  bool is_bool = element.get_yalll_type() == YALLLParser::BOOL_T;
+  bool is_integer = element.get_llvm_type()->isIntegerTy() &&
+                    !element.is_error() && !element.is_object();
+
+  bool valid = false;
+  switch (kind) {
+    // llvm.expect doesn't exist for vectors
+    case Kind::Expect:
+      valid = is_integer && !operand_type.is_vector();
+      break;
+    case Kind::ByteSwap:
+      valid = is_integer && !is_bool &&
+              element.get_llvm_type()->getIntegerBitWidth() % 16 == 0;
+      break;
+    case Kind::Popcount:
+    case Kind::CountLeading:
+    case Kind::CountTrailing:
+    case Kind::RotateLeft:
+    case Kind::RotateRight:
+      valid = is_integer && !is_bool;
+      break;
+    case Kind::Fma:
+    case Kind::Sqrt:
+      valid = element.is_float_type();
+      break;
+    case Kind::Min:
+    case Kind::Max:
+    case Kind::Abs:
+      valid = (is_integer && !is_bool) || element.is_float_type();
+      break;
+    case Kind::Prefetch:
+      valid = operand_type.is_object();
+      break;
+    case Kind::CycleCounter:
+      valid = true;
+      break;
+  }
+  if (!valid) {
+    logger->send_error("{} in line {} doesn't work on {}", name, line,
+                       operand_type.to_string());
+    return false;
+  }
+
+  result_type = kind == Kind::Prefetch ? typesafety::TypeInformation::VOID_T()
+                                       : operand_type;
+  return true;
+}
+
+bool IntrinsicOperation::is_speculatable() {
+  // prefetch and the cycle counter are observable, everything else is pure
+  if (kind == Kind::Prefetch || kind == Kind::CycleCounter) return false;
+  return Operation::is_speculatable();
+}
+}  // namespace yalll
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <llvm/IR/IRBuilder.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "operation.h"
+
+namespace yalll {
+
+// Builtins that map onto a single LLVM intrinsic. Everything but expect,
+// prefetch and cycle_counter works on vectors as well, element by element.
+class IntrinsicOperation : public Operation {
+ public:
+  enum class Kind {
+    Expect,         // expect(value, constant)
+    Popcount,       // popcount(x)
+    CountLeading,   // clz(x), the bit width for 0
+    CountTrailing,  // ctz(x), the bit width for 0
+    ByteSwap,       // bswap(x)
+    RotateLeft,     // rotl(x, n)
+    RotateRight,    // rotr(x, n)
+    Fma,            // fma(a, b, c) = a * b + c, rounded once
+    Sqrt,           // sqrt(x)
+    Min,            // min(a, b)
+    Max,            // max(a, b)
+    Abs,            // abs(x)
+    Prefetch,       // prefetch(object)
+    CycleCounter,   // cycle_counter()
+  };
+  static std::optional<Kind> from_name(const std::string& name);
+  static size_t operand_count(Kind kind);
+
+  using Operation::Operation;
+  explicit IntrinsicOperation(Kind kind,
+                              std::vector<std::shared_ptr<Operation>> operands,
+                              const std::string& name, size_t line)
+      : Operation(operands, std::vector<size_t>()),
+        kind(kind),
+        name(name),
+        line(line) {}
+  Value generate_value() override;
+  std::vector<typesafety::TypeProposal> gather_and_resolve_proposals() override;
+  bool is_speculatable() override;
+
+ private:
+  // checks the resolved operand type and computes the type of the result
+  bool resolve_result_type(typesafety::TypeInformation& operand_type);
+
+  Kind kind;
+  std::string name;
+  size_t line;
+  typesafety::TypeInformation operand_type;
+  typesafety::TypeInformation result_type;
+  bool resolved = false;
+  Import<llvm::IRBuilder<>> builder;
+};
+}  // namespace yalll
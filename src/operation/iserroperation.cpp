@@ -0,0 +1,34 @@
+#include "iserroperation.h"
+
+#include <vector>
+
+namespace yalll {
+
+Value IserrOperation::generate_value() {
+  auto value = operations.at(0)->generate_value();
+  logger->send_log("GenIserr: {}", value.to_string());
+
+  auto bool_type = typesafety::TypeInformation::BOOL_T();
+  llvm::Value* error = nullptr;
+  if (value.err_id) {
+    error = value.err_id;
+  } else if (value.type_info.is_error()) {
+    error = value.get_llvm_val();
+  } else {
+    // calls of noerr functions never return an error
+    return Value(bool_type, builder->getFalse(), line);
+  }
+  return Value(bool_type,
+               builder->CreateICmpNE(
+                   error, llvm::ConstantInt::get(error->getType(), 0), "iserr"),
+               line);
+}
+
+std::vector<typesafety::TypeProposal>
+IserrOperation::gather_and_resolve_proposals() {
+  auto proposals = operations.at(0)->gather_and_resolve_proposals();
+  (void)typesafety::TypeResolver::try_resolve(proposals);
+  return std::vector<typesafety::TypeProposal>{
+      typesafety::TypeProposal{YALLLParser::BOOL_T, true, nullptr}};
+}
+}  // namespace yalll
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <llvm/IR/IRBuilder.h>
+
+#include "operation.h"
+
+namespace yalll {
+
+// iserr value, true if an errable call returned an error or an error value
+// isn't `no error`
+class IserrOperation : public Operation {
+ public:
+  using Operation::Operation;
+  explicit IserrOperation(std::shared_ptr<Operation> value, size_t line)
+      : Operation({value}, std::vector<size_t>()), line(line) {}
+  Value generate_value() override;
+  std::vector<typesafety::TypeProposal> gather_and_resolve_proposals() override;
+
+ private:
+  size_t line;
+  Import<llvm::IRBuilder<>> builder;
+};
+}  // namespace yalll
@@ -15,6 +15,7 @@ Value MulOperation::generate_value() {
 
   for (auto i = 0; i < op_codes.size(); ++i) {
     auto rhs = operations[i + 1]->generate_value();
+    match_vector_operands(lhs, rhs);
     switch (op_codes[i]) {
       case YALLLParser::MUL_SYM:
         if (float_mode) {
@@ -84,4 +85,14 @@ MulOperation::gather_and_resolve_proposals() {
 
   return std::move(proposals);
 }
+
+bool MulOperation::is_speculatable() {
+  // integer division by zero traps, the type isn't known yet so floats are
+  // treated the same
+  for (auto op_code : op_codes) {
+    if (op_code == YALLLParser::DIV_SYM || op_code == YALLLParser::MOD_SYM)
+      return false;
+  }
+  return Operation::is_speculatable();
+}
 }  // namespace yalll
@@ -11,5 +11,6 @@ class MulOperation : public Operation {
   using Operation::Operation;
   Value generate_value() override;
   std::vector<typesafety::TypeProposal> gather_and_resolve_proposals() override;
+  bool is_speculatable() override;
 };
 }  // namespace yalll
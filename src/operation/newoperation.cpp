@@ -0,0 +1,42 @@
+#include "newoperation.h"
+
+#include <llvm/IR/Instructions.h>
+
+namespace yalll {
+
+Value NewOperation::generate_value() {
+  logger->send_log("Generating new {}", target.get_name());
+  auto* function = builder->GetInsertBlock()->getParent();
+  auto& layout = function->getParent()->getDataLayout();
+
+  llvm::Value* object;
+  if (owner) {
+    object = owner->generate_alloc(owner_ptr, target.get_llvm_type(), layout);
+    if (!object) {
+      return Value(typesafety::TypeInformation::OBJECT_T(target.get_name()),
+                   llvm::PoisonValue::get(builder->getPtrTy()), line);
+    }
+  } else {
+    // allocas in the entry block are static, so new in a branch doesn't grow
+    // the stack frame dynamically
+    llvm::IRBuilder<> entry_builder(&function->getEntryBlock(),
+                                    function->getEntryBlock().begin());
+    auto* alloca = entry_builder.CreateAlloca(target.get_llvm_type(), nullptr,
+                                              target.get_name());
+    alloca->setAlignment(llvm::Align(Class::OBJECT_MEMORY_ALIGNMENT));
+    object = alloca;
+  }
+
+  // fresh objects start with empty object memory
+  target.generate_reset(object);
+
+  return Value(typesafety::TypeInformation::OBJECT_T(target.get_name()),
+               object, line);
+}
+
+std::vector<typesafety::TypeProposal>
+NewOperation::gather_and_resolve_proposals() {
+  return std::move(std::vector<typesafety::TypeProposal>{
+      typesafety::TypeProposal{typesafety::OBJECT_T_ID, true, nullptr}});
+}
+}  // namespace yalll
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <llvm/IR/IRBuilder.h>
+
+#include "../class/class.h"
+#include "operation.h"
+
+namespace yalll {
+
+class NewOperation : public Operation {
+ public:
+  using Operation::Operation;
+  // owner is the class whose object memory is used, without an owner the
+  // object is created on the stack frame of the current function
+  explicit NewOperation(Class& target, Class* owner, llvm::Value* owner_ptr,
+                        size_t line)
+      : target(target), owner(owner), owner_ptr(owner_ptr), line(line) {}
+  Value generate_value() override;
+  std::vector<typesafety::TypeProposal> gather_and_resolve_proposals() override;
+  bool is_speculatable() override { return false; }
+
+ private:
+  Class& target;
+  Class* owner;
+  llvm::Value* owner_ptr;
+  size_t line;
+  Import<llvm::IRBuilder<>> builder;
+};
+}  // namespace yalll
@@ -0,0 +1,87 @@
+#include "onerroperation.h"
+
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/MDBuilder.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace yalll {
+
+Value OnerrOperation::generate_value() {
+  auto value = operations.at(0)->generate_value();
+  logger->send_log("GenOnerr: {} with {} handlers", value.to_string(),
+                   handlers.size());
+  if (!value.err_id) return value;
+
+  auto& context = builder->getContext();
+  auto* function = builder->GetInsertBlock()->getParent();
+  auto* dispatch = llvm::BasicBlock::Create(context, "onerr", function);
+  auto* onerr_exit = llvm::BasicBlock::Create(context, "onerr_exit");
+
+  llvm::MDBuilder md_builder(context);
+  builder->CreateCondBr(
+      builder->CreateICmpNE(value.err_id, builder->getInt16(0)), dispatch,
+      onerr_exit, md_builder.createBranchWeights(1, 2000));
+  auto* no_error = builder->GetInsertBlock();
+
+  // handlers sharing their statements share a block
+  builder->SetInsertPoint(dispatch);
+  auto* default_block =
+      llvm::BasicBlock::Create(context, "onerr_default", function);
+  auto* switch_inst =
+      builder->CreateSwitch(value.err_id, default_block, handlers.size());
+  std::map<size_t, llvm::BasicBlock*> bodies;
+  for (auto& handler : handlers) {
+    if (!bodies.contains(handler.body)) {
+      bodies.insert(std::pair<size_t, llvm::BasicBlock*>(
+          handler.body,
+          llvm::BasicBlock::Create(context, "onerr_case", function)));
+    }
+    switch_inst->addCase(handler.error_id, bodies.at(handler.body));
+  }
+
+  // a handled error leaves the zero value behind
+  std::vector<llvm::BasicBlock*> handled;
+  auto generate = [&](llvm::BasicBlock* block, size_t body) {
+    builder->SetInsertPoint(block);
+    generate_body(body);
+    if (!builder->GetInsertBlock()->getTerminator()) {
+      handled.push_back(builder->GetInsertBlock());
+      builder->CreateBr(onerr_exit);
+    }
+  };
+  for (auto& [body, block] : bodies) {
+    generate(block, body);
+  }
+  if (default_body) {
+    generate(default_block, *default_body);
+  } else {
+    builder->SetInsertPoint(default_block);
+    generate_default(value.err_id);
+  }
+
+  onerr_exit->insertInto(function);
+  builder->SetInsertPoint(onerr_exit);
+  value.err_id = nullptr;
+  if (!value.llvm_val || handled.empty()) return value;
+
+  auto* phi = builder->CreatePHI(value.llvm_val->getType(), handled.size() + 1);
+  phi->addIncoming(value.llvm_val, no_error);
+  for (auto* block : handled) {
+    phi->addIncoming(llvm::Constant::getNullValue(phi->getType()), block);
+  }
+  return Value(value.type_info, phi, line);
+}
+
+void OnerrOperation::generate_default(llvm::Value* err_id) {
+  // every error the call can return has a handler
+  if (covers_all || !caller || !caller->can_return_errors()) {
+    builder->CreateUnreachable();
+    return;
+  }
+  caller->generate_error_return(err_id);
+}
+}  // namespace yalll
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/IRBuilder.h>
+
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "../function/function.h"
+#include "funccalloperation.h"
+#include "operation.h"
+
+namespace yalll {
+
+// error: handler of onerr, body is the index of the statements handling it
+struct OnerrHandler {
+  llvm::ConstantInt* error_id;
+  size_t body;
+};
+
+// call onerr { error: ... default: ... }
+// The error id of the call is dispatched with a single switch over the
+// errors that are handled, so handling an error is O(1) no matter how many
+// handlers there are. Handlers for errors the call can't return are already
+// dropped by the caller of the constructor.
+class OnerrOperation : public Operation {
+ public:
+  using Operation::Operation;
+  explicit OnerrOperation(std::shared_ptr<FuncCallOperation> call,
+                          std::vector<OnerrHandler> handlers,
+                          std::optional<size_t> default_body, bool covers_all,
+                          Function* caller,
+                          std::function<void(size_t)> generate_body,
+                          size_t line)
+      : Operation({call}, std::vector<size_t>()),
+        handlers(handlers),
+        default_body(default_body),
+        covers_all(covers_all),
+        caller(caller),
+        generate_body(generate_body),
+        line(line) {}
+  Value generate_value() override;
+  bool is_speculatable() override { return false; }
+
+ private:
+  // the errors that aren't handled, either the default body, propagation to
+  // the caller or unreachable if there are none left
+  void generate_default(llvm::Value* err_id);
+
+  std::vector<OnerrHandler> handlers;
+  std::optional<size_t> default_body;
+  bool covers_all;
+  Function* caller;
+  std::function<void(size_t)> generate_body;
+  size_t line;
+  Import<llvm::IRBuilder<>> builder;
+};
+}  // namespace yalll
@@ -49,6 +49,92 @@ Operation::gather_and_resolve_proposals() {
   return std::move(proposals);
 }
 
+bool Operation::is_speculatable() {
+  for (auto op : operations) {
+    if (!op->is_speculatable()) return false;
+  }
+  return true;
+}
+
+llvm::Value* Operation::generate_short_circuit(
+    bool is_and, size_t count,
+    const std::function<llvm::Value*(size_t)>& generate_link,
+    const std::function<bool(size_t)>& is_speculatable_link) {
+  Import<llvm::IRBuilder<>> builder;
+  llvm::Value* result = generate_link(0);
+
+  // a branching link jumps to the merge block as soon as the result is
+  // decided, the later links are generated on the path that wasn't decided
+  // yet. Everything a link generates dominates the later links, so they can
+  // reuse values of earlier links (i.e. the operands of a < b < c).
+  llvm::BasicBlock* merge_block = nullptr;
+  std::vector<llvm::BasicBlock*> decided_blocks;
+  for (auto i = 1; i < count; ++i) {
+    if (is_speculatable_link(i)) {
+      auto* rhs = generate_link(i);
+      result = is_and ? builder->CreateLogicalAnd(result, rhs)
+                      : builder->CreateLogicalOr(result, rhs);
+      continue;
+    }
+
+    auto* lhs_block = builder->GetInsertBlock();
+    auto* rhs_block =
+        llvm::BasicBlock::Create(builder->getContext(),
+                                 is_and ? "and_rhs" : "or_rhs",
+                                 lhs_block->getParent());
+    if (!merge_block) {
+      merge_block = llvm::BasicBlock::Create(builder->getContext(),
+                                             is_and ? "and_merge" : "or_merge");
+    }
+
+    if (is_and)
+      builder->CreateCondBr(result, rhs_block, merge_block);
+    else
+      builder->CreateCondBr(result, merge_block, rhs_block);
+    decided_blocks.push_back(lhs_block);
+
+    builder->SetInsertPoint(rhs_block);
+    result = generate_link(i);
+  }
+  if (!merge_block) return result;
+
+  // the last link may have branched itself
+  auto* rhs_end = builder->GetInsertBlock();
+  builder->CreateBr(merge_block);
+  merge_block->insertInto(rhs_end->getParent());
+  builder->SetInsertPoint(merge_block);
+  auto* phi =
+      builder->CreatePHI(builder->getInt1Ty(), decided_blocks.size() + 1);
+  for (auto* decided_block : decided_blocks) {
+    phi->addIncoming(builder->getInt1(!is_and), decided_block);
+  }
+  phi->addIncoming(result, rhs_end);
+  return phi;
+}
+
+void Operation::match_vector_operands(Value& lhs, Value& rhs) {
+  bool lhs_vector = lhs.get_llvm_val()->getType()->isVectorTy();
+  bool rhs_vector = rhs.get_llvm_val()->getType()->isVectorTy();
+  if (lhs_vector && !rhs_vector) splat_to(rhs, lhs.type_info);
+  if (rhs_vector && !lhs_vector) splat_to(lhs, rhs.type_info);
+}
+
+void Operation::splat_to(Value& value, typesafety::TypeInformation& type_info) {
+  Import<llvm::IRBuilder<>> builder;
+  auto* llvm_val = value.get_llvm_val();
+  if (!llvm_val || llvm_val->getType()->isVectorTy()) return;
+
+  value.llvm_val = builder->CreateVectorSplat(type_info.get_lanes(), llvm_val);
+  value.type_info = type_info;
+}
+
+typesafety::TypeInformation Operation::resolved_type(
+    typesafety::TypeProposal& proposal) {
+  // fixed proposals don't carry a value, only their type
+  if (proposal.attached_value) return proposal.attached_value->type_info;
+  return typesafety::TypeInformation::from_yalll_t(proposal.yalll_type);
+}
+
 bool Operation::resolve_with_type_info(typesafety::TypeInformation type_info) {
   auto proposals = gather_and_resolve_proposals();
   logger->send_log("Operation tries to resolve to {}", type_info.to_string());
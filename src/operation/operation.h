@@ -4,6 +4,7 @@
 #include <llvm/IR/LLVMContext.h>
 
 #include <cstddef>
+#include <functional>
 #include <vector>
 
 #include "../typesafety/typeresolver.h"
@@ -40,7 +41,27 @@ class Operation {
   bool resolve_with_type_info(typesafety::TypeInformation type_info);
   bool resolve_without_type_info();
 
+  // can be evaluated even if the result isn't needed, i.e. it has no side
+  // effects and can't trap
+  virtual bool is_speculatable();
+
  protected:
+  // evaluates count links one after another, but stops at the first link
+  // deciding the result (false for and, true for or). Speculatable links are
+  // evaluated without branching and combined using select.
+  llvm::Value* generate_short_circuit(
+      bool is_and, size_t count,
+      const std::function<llvm::Value*(size_t)>& generate_link,
+      const std::function<bool(size_t)>& is_speculatable_link);
+
+  // a scalar mixed with a vector is splatted into every lane, afterwards both
+  // operands have the same shape
+  static void match_vector_operands(Value& lhs, Value& rhs);
+  static void splat_to(Value& value, typesafety::TypeInformation& type_info);
+  // the type a resolved proposal ended up with
+  static typesafety::TypeInformation resolved_type(
+      typesafety::TypeProposal& proposal);
+
   std::vector<std::shared_ptr<Operation>> operations;
   std::vector<size_t> op_codes;
   Import<util::Logger> logger;
@@ -7,18 +7,19 @@
 namespace yalll {
 
 Value OrOperation::generate_value() {
-  Value lhs = operations.at(0)->generate_value();
+  size_t line = 0;
+  auto* result = generate_short_circuit(
+      false, operations.size(),
+      [&](size_t i) {
+        auto value = operations.at(i)->generate_value();
+        line = value.get_line();
+        return value.get_llvm_val();
+      },
+      [&](size_t i) { return operations.at(i)->is_speculatable(); });
 
-  yalll::Import<llvm::IRBuilder<>> builder;
-  for (auto i = 0; i < op_codes.size(); ++i) {
-    auto rhs = operations[i + 1]->generate_value();
-    lhs = Value(lhs.type_info,
-                builder->CreateOr(lhs.get_llvm_val(), rhs.get_llvm_val()),
-                lhs.get_line());
-  }
-
-  logger->send_log("GenOr: {}", lhs.to_string());
-  return std::move(lhs);
+  Value value(typesafety::TypeInformation::BOOL_T(), result, line);
+  logger->send_log("GenOr: {}", value.to_string());
+  return std::move(value);
 }
 
 std::vector<typesafety::TypeProposal>
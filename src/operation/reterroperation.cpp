@@ -0,0 +1,30 @@
+#include "reterroperation.h"
+
+#include <vector>
+
+namespace yalll {
+
+Value ReterrOperation::generate_value() {
+  auto error = operations.at(0)->generate_value();
+  logger->send_log("GenReterr: {}", error.to_string());
+
+  if (!caller.can_return_errors()) {
+    logger->send_error("reterr in line {} inside of noerr function {}", line,
+                       caller.get_llvm_name());
+  } else {
+    caller.generate_error_return(error.get_llvm_val());
+  }
+  return Value(typesafety::TypeInformation::VOID_T(), nullptr, line);
+}
+
+std::vector<typesafety::TypeProposal>
+ReterrOperation::gather_and_resolve_proposals() {
+  auto proposals = operations.at(0)->gather_and_resolve_proposals();
+  auto error_type = typesafety::TypeInformation::ERROR_T();
+  if (!typesafety::TypeResolver::try_resolve_to_type(proposals, error_type)) {
+    logger->send_error("reterr in line {} needs an error", line);
+  }
+  // reterr leaves the function, there is no value left
+  return std::vector<typesafety::TypeProposal>();
+}
+}  // namespace yalll
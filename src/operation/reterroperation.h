@@ -0,0 +1,28 @@
+#pragma once
+
+#include <llvm/IR/IRBuilder.h>
+
+#include "../function/function.h"
+#include "operation.h"
+
+namespace yalll {
+
+// reterr error, returns the error from the active function
+class ReterrOperation : public Operation {
+ public:
+  using Operation::Operation;
+  explicit ReterrOperation(std::shared_ptr<Operation> error, Function& caller,
+                           size_t line)
+      : Operation({error}, std::vector<size_t>()),
+        caller(caller),
+        line(line) {}
+  Value generate_value() override;
+  std::vector<typesafety::TypeProposal> gather_and_resolve_proposals() override;
+  bool is_speculatable() override { return false; }
+
+ private:
+  Function& caller;
+  size_t line;
+  Import<llvm::IRBuilder<>> builder;
+};
+}  // namespace yalll
@@ -4,6 +4,12 @@ namespace yalll {
 
 Value TerminalOperation::generate_value() {
   logger->send_log("GenTerm: {}", terminal_value.to_string());
+  // a scalar that was resolved to a vector type is used in every lane
+  if (terminal_value.type_info.is_vector()) {
+    auto value = terminal_value;
+    splat_to(value, terminal_value.type_info);
+    return value;
+  }
   return terminal_value;
 }
 
@@ -0,0 +1,263 @@
+#include "vectoroperation.h"
+
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DerivedTypes.h>
+
+#include <map>
+#include <vector>
+
+namespace yalll {
+
+std::optional<VectorOperation::Kind> VectorOperation::from_name(
+    const std::string& name) {
+  static const std::map<std::string, Kind> builtins = {
+      {"splat", Kind::Splat},          {"lane", Kind::Lane},
+      {"with_lane", Kind::WithLane},   {"shuffle", Kind::Shuffle},
+      {"select", Kind::Select},        {"reduce_add", Kind::ReduceAdd},
+      {"reduce_mul", Kind::ReduceMul}, {"reduce_min", Kind::ReduceMin},
+      {"reduce_max", Kind::ReduceMax}, {"reduce_and", Kind::ReduceAnd},
+      {"reduce_or", Kind::ReduceOr},   {"reduce_xor", Kind::ReduceXor},
+      {"all", Kind::ReduceAnd},        {"any", Kind::ReduceOr}};
+  if (!builtins.contains(name)) return std::nullopt;
+  return builtins.at(name);
+}
+
+size_t VectorOperation::operand_count(Kind kind) {
+  switch (kind) {
+    case Kind::Splat:
+      return 1;
+    case Kind::Lane:
+    case Kind::Shuffle:
+      return 2;
+    case Kind::WithLane:
+    case Kind::Select:
+      return 3;
+    default:
+      return 1;
+  }
+}
+
+Value VectorOperation::generate_value() {
+  if (!resolved) {
+    return Value(typesafety::TypeInformation::VOID_T(),
+                 llvm::PoisonValue::get(builder->getVoidTy()), line);
+  }
+
+  std::vector<llvm::Value*> values;
+  for (auto op : operations) {
+    values.push_back(op->generate_value().get_llvm_val());
+  }
+
+  llvm::Value* result = nullptr;
+  switch (kind) {
+    case Kind::Splat:
+      result = builder->CreateVectorSplat(result_type.get_lanes(),
+                                          values.at(0), "splat");
+      break;
+    case Kind::Lane:
+      check_lane(values.at(0), values.at(1));
+      result = builder->CreateExtractElement(values.at(0), values.at(1));
+      break;
+    case Kind::WithLane:
+      check_lane(values.at(0), values.at(1));
+      result = builder->CreateInsertElement(values.at(0), values.at(2),
+                                            values.at(1));
+      break;
+    case Kind::Shuffle:
+      result = builder->CreateShuffleVector(values.at(0), values.at(1),
+                                            constants, "shuffle");
+      break;
+    case Kind::Select:
+      result = builder->CreateSelect(values.at(0), values.at(1), values.at(2));
+      break;
+    default:
+      result = generate_reduction(values.at(0));
+      break;
+  }
+
+  Value value(result_type, result, line);
+  logger->send_log("GenVector: {}", value.to_string());
+  return std::move(value);
+}
+
+void VectorOperation::check_lane(llvm::Value* vector, llvm::Value* index) {
+  // a lane that doesn't exist is poison, so constant ones are rejected
+  auto* constant = llvm::dyn_cast<llvm::ConstantInt>(index);
+  auto lanes =
+      llvm::cast<llvm::FixedVectorType>(vector->getType())->getNumElements();
+  if (constant && constant->getZExtValue() >= lanes) {
+    logger->send_error("Lane {} in line {} is out of range, there are {}",
+                       constant->getZExtValue(), line, lanes);
+  }
+}
+
+llvm::Value* VectorOperation::generate_reduction(llvm::Value* vector) {
+  auto element = result_type;
+  bool float_mode = element.is_float_type();
+  auto* type = element.get_llvm_type();
+
+  // float reductions are done in lane order, unless fast math allows to
+  // reassociate them into a tree
+  switch (kind) {
+    case Kind::ReduceAdd:
+      return float_mode ? builder->CreateFAddReduce(
+                              llvm::ConstantFP::getNegativeZero(type), vector)
+                        : builder->CreateAddReduce(vector);
+    case Kind::ReduceMul:
+      return float_mode ? builder->CreateFMulReduce(
+                              llvm::ConstantFP::get(type, 1.0), vector)
+                        : builder->CreateMulReduce(vector);
+    case Kind::ReduceMin:
+      return float_mode ? builder->CreateFPMinReduce(vector)
+                        : builder->CreateIntMinReduce(vector,
+                                                      element.is_signed());
+    case Kind::ReduceMax:
+      return float_mode ? builder->CreateFPMaxReduce(vector)
+                        : builder->CreateIntMaxReduce(vector,
+                                                      element.is_signed());
+    case Kind::ReduceAnd:
+      return builder->CreateAndReduce(vector);
+    case Kind::ReduceOr:
+      return builder->CreateOrReduce(vector);
+    case Kind::ReduceXor:
+      return builder->CreateXorReduce(vector);
+    default:
+      logger->send_internal_error("Vector builtin {} isn't a reduction",
+                                  static_cast<int>(kind));
+      return nullptr;
+  }
+}
+
+std::vector<typesafety::TypeProposal>
+VectorOperation::gather_and_resolve_proposals() {
+  // every operand is resolved on its own, vector builtins don't mix types
+  std::vector<typesafety::TypeInformation> types;
+  for (auto i = 0; i < operations.size(); ++i) {
+    auto proposals = operations.at(i)->gather_and_resolve_proposals();
+    // the value stored into a lane has the type of the elements
+    bool resolved_operand = false;
+    if (kind == Kind::WithLane && i == 2 && types.at(0).is_vector()) {
+      auto element = types.at(0).get_element_type();
+      resolved_operand =
+          typesafety::TypeResolver::try_resolve_to_type(proposals, element);
+    } else {
+      resolved_operand = typesafety::TypeResolver::try_resolve(proposals);
+    }
+    if (proposals.empty() || !resolved_operand) {
+      logger->send_error("Invalid operand for vector builtin in line {}",
+                         line);
+      return std::vector<typesafety::TypeProposal>();
+    }
+    types.push_back(resolved_type(proposals.front()));
+  }
+
+  resolved = resolve_result_type(types);
+  if (!resolved) return std::vector<typesafety::TypeProposal>();
+  return std::vector<typesafety::TypeProposal>{typesafety::TypeProposal{
+      result_type.get_yalll_type(), true, nullptr}};
+}
+
+bool VectorOperation::resolve_result_type(
+    std::vector<typesafety::TypeInformation>& types) {
+  auto is_integer = [](typesafety::TypeInformation& type) {
+    return type.get_llvm_type()->isIntegerTy() && !type.is_error();
+  };
+
+  // invalid constants were already reported
+  bool takes_constants = kind == Kind::Splat || kind == Kind::Shuffle;
+  if (takes_constants && constants.empty()) return false;
+
+  switch (kind) {
+    case Kind::Splat: {
+      auto lanes = constants.front();
+      if (types.at(0).is_vector() || !(is_integer(types.at(0)) ||
+                                       types.at(0).is_float_type())) {
+        logger->send_error("splat in line {} needs a number or bool", line);
+        return false;
+      }
+      if (lanes < 2 || lanes > typesafety::MAX_VECTOR_LANES ||
+          (lanes & (lanes - 1)) != 0) {
+        logger->send_error(
+            "splat in line {} needs a power of two from 2 to {} lanes", line,
+            typesafety::MAX_VECTOR_LANES);
+        return false;
+      }
+      result_type = typesafety::TypeInformation::VEC_T(types.at(0), lanes);
+      return true;
+    }
+
+    case Kind::Lane:
+    case Kind::WithLane: {
+      if (!types.at(0).is_vector() || !is_integer(types.at(1))) {
+        logger->send_error("Lane access in line {} needs a vector and an index",
+                           line);
+        return false;
+      }
+      if (kind == Kind::WithLane &&
+          !types.at(0).get_element_type().is_compatible(types.at(2))) {
+        logger->send_error("with_lane in line {} can't store {} into {}",
+                           line, types.at(2).to_string(),
+                           types.at(0).to_string());
+        return false;
+      }
+      result_type =
+          kind == Kind::Lane ? types.at(0).get_element_type() : types.at(0);
+      return true;
+    }
+
+    case Kind::Shuffle: {
+      if (!types.at(0).is_vector() ||
+          types.at(0).get_yalll_type() != types.at(1).get_yalll_type()) {
+        logger->send_error("shuffle in line {} needs two vectors of one type",
+                           line);
+        return false;
+      }
+      for (auto index : constants) {
+        if (index < 0 ||
+            index >= 2 * static_cast<int>(types.at(0).get_lanes())) {
+          logger->send_error("Shuffle index {} in line {} is out of range",
+                             index, line);
+          return false;
+        }
+      }
+      result_type = typesafety::TypeInformation::VEC_T(
+          types.at(0).get_element_type(), constants.size());
+      return true;
+    }
+
+    case Kind::Select: {
+      auto& mask = types.at(0);
+      if (!mask.is_vector() ||
+          mask.get_element_type().get_yalll_type() != YALLLParser::BOOL_T ||
+          types.at(1).get_yalll_type() != types.at(2).get_yalll_type() ||
+          types.at(1).get_lanes() != mask.get_lanes()) {
+        logger->send_error(
+            "select in line {} needs a mask and two vectors of its size",
+            line);
+        return false;
+      }
+      result_type = types.at(1);
+      return true;
+    }
+
+    default: {
+      auto& vector = types.at(0);
+      if (!vector.is_vector()) {
+        logger->send_error("Reduction in line {} needs a vector", line);
+        return false;
+      }
+      auto element = vector.get_element_type();
+      bool bitwise = kind == Kind::ReduceAnd || kind == Kind::ReduceOr ||
+                     kind == Kind::ReduceXor;
+      bool is_bool = element.get_yalll_type() == YALLLParser::BOOL_T;
+      if ((bitwise && element.is_float_type()) || (!bitwise && is_bool)) {
+        logger->send_error("Reduction in line {} doesn't work on {}", line,
+                           vector.to_string());
+        return false;
+      }
+      result_type = element;
+      return true;
+    }
+  }
+}
+}  // namespace yalll
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <llvm/IR/IRBuilder.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "operation.h"
+
+namespace yalll {
+
+// Builtins working on vectors: splats, lane access, shuffles, select and
+// horizontal reductions. Element-wise arithmetic doesn't need a builtin, the
+// regular operators work on vectors as well.
+class VectorOperation : public Operation {
+ public:
+  enum class Kind {
+    Splat,     // splat(x, lanes)
+    Lane,      // lane(v, i)
+    WithLane,  // with_lane(v, i, x)
+    Shuffle,   // shuffle(a, b, i...), i indexes the lanes of a then b
+    Select,    // select(mask, a, b)
+    ReduceAdd,
+    ReduceMul,
+    ReduceMin,
+    ReduceMax,
+    ReduceAnd,  // all(mask) as well
+    ReduceOr,   // any(mask) as well
+    ReduceXor,
+  };
+  static std::optional<Kind> from_name(const std::string& name);
+  // splat and shuffle take integer constants after the vector operands
+  static size_t operand_count(Kind kind);
+
+  using Operation::Operation;
+  explicit VectorOperation(Kind kind,
+                           std::vector<std::shared_ptr<Operation>> operands,
+                           std::vector<int> constants, size_t line)
+      : Operation(operands, std::vector<size_t>()),
+        kind(kind),
+        constants(constants),
+        line(line) {}
+  Value generate_value() override;
+  std::vector<typesafety::TypeProposal> gather_and_resolve_proposals() override;
+
+ private:
+  // checks the operand types and computes the type of the result
+  bool resolve_result_type(std::vector<typesafety::TypeInformation>& types);
+  void check_lane(llvm::Value* vector, llvm::Value* index);
+  llvm::Value* generate_reduction(llvm::Value* vector);
+
+  Kind kind;
+  std::vector<int> constants;
+  size_t line;
+  typesafety::TypeInformation result_type;
+  bool resolved = false;
+  Import<llvm::IRBuilder<>> builder;
+};
+}  // namespace yalll
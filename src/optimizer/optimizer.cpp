@@ -0,0 +1,137 @@
+#include "optimizer.h"
+
+#include <llvm/Analysis/CGSCCPassManager.h>
+#include <llvm/Analysis/LoopAnalysisManager.h>
+#include <llvm/IR/InstrTypes.h>
+#include <llvm/IR/PassManager.h>
+#include <llvm/Passes/OptimizationLevel.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Support/PGOOptions.h>
+#include <llvm/Support/VirtualFileSystem.h>
+#include <llvm/Transforms/IPO/ArgumentPromotion.h>
+#include <llvm/Transforms/IPO/GlobalDCE.h>
+#include <llvm/Transforms/IPO/SCCP.h>
+
+#include <filesystem>
+#include <optional>
+
+namespace yallc {
+
+inline llvm::OptimizationLevel to_optimization_level(unsigned level) {
+  switch (level) {
+    case 0:
+      return llvm::OptimizationLevel::O0;
+    case 1:
+      return llvm::OptimizationLevel::O1;
+    case 2:
+      return llvm::OptimizationLevel::O2;
+    default:
+      return llvm::OptimizationLevel::O3;
+  }
+}
+
+inline bool has_musttail_call(llvm::Function& function) {
+  for (auto& block : function) {
+    if (block.getTerminatingMustTailCall()) return true;
+  }
+  return false;
+}
+
+// the caller of a musttail call keeps its convention, so the callee has to
+// keep it as well
+inline bool is_musttail_callee(llvm::Function& function) {
+  for (auto* user : function.users()) {
+    auto* call = llvm::dyn_cast<llvm::CallInst>(user);
+    if (call && call->isMustTailCall()) return true;
+  }
+  return false;
+}
+
+bool Optimizer::optimize(llvm::Module& module) {
+  std::optional<llvm::PGOOptions> pgo_options;
+  if (options->profile_generate) {
+    // counters are written to the path when the program exits
+    pgo_options = llvm::PGOOptions(options->profile_generate_path, "", "", "",
+                                   llvm::vfs::getRealFileSystem(),
+                                   llvm::PGOOptions::IRInstr);
+  } else if (!options->profile_use.empty()) {
+    if (!std::filesystem::exists(options->profile_use)) {
+      logger->send_error("Profile {} doesn't exist", options->profile_use);
+      return false;
+    }
+    // branch weights and function entry counts come from the merged profile
+    pgo_options = llvm::PGOOptions(options->profile_use, "", "", "",
+                                   llvm::vfs::getRealFileSystem(),
+                                   llvm::PGOOptions::IRUse);
+  }
+
+  if (options->opt_level == 0 && !pgo_options && !options->whole_program)
+    return true;
+  logger->send_log("Optimizing {} with -O{}", module.getName().str(),
+                   options->opt_level);
+
+  llvm::LoopAnalysisManager loop_analysis;
+  llvm::FunctionAnalysisManager function_analysis;
+  llvm::CGSCCAnalysisManager cgscc_analysis;
+  llvm::ModuleAnalysisManager module_analysis;
+
+  llvm::PassBuilder pass_builder(target_machine, llvm::PipelineTuningOptions(),
+                                 pgo_options);
+  pass_builder.registerModuleAnalyses(module_analysis);
+  pass_builder.registerCGSCCAnalyses(cgscc_analysis);
+  pass_builder.registerFunctionAnalyses(function_analysis);
+  pass_builder.registerLoopAnalyses(loop_analysis);
+  pass_builder.crossRegisterProxies(loop_analysis, function_analysis,
+                                    cgscc_analysis, module_analysis);
+
+  llvm::ModulePassManager pass_manager;
+  // constants are propagated into internal functions, pointers to small
+  // values become values and whatever isn't called anymore is deleted
+  if (options->whole_program) {
+    pass_manager.addPass(llvm::IPSCCPPass());
+    pass_manager.addPass(llvm::createModuleToPostOrderCGSCCPassAdaptor(
+        llvm::ArgumentPromotionPass()));
+    pass_manager.addPass(llvm::GlobalDCEPass());
+  }
+
+  auto level = to_optimization_level(options->opt_level);
+  pass_manager.addPass(level == llvm::OptimizationLevel::O0
+                           ? pass_builder.buildO0DefaultPipeline(level)
+                           : pass_builder.buildPerModuleDefaultPipeline(level));
+  pass_manager.run(module, module_analysis);
+  return true;
+}
+
+void Optimizer::internalize(llvm::Module& module,
+                            const std::set<std::string>& exported) {
+  logger->send_log("Internalizing {}", module.getName().str());
+  ++*logger;
+
+  for (auto& function : module) {
+    if (function.isDeclaration() || function.hasLocalLinkage()) continue;
+    auto name = function.getName().str();
+    if (name == "main" || exported.contains(name)) continue;
+
+    function.setLinkage(llvm::GlobalValue::InternalLinkage);
+    logger->send_log("{} is internal", name);
+
+    // the calling convention can only change if every caller is known, tailcc
+    // of recursive functions is kept for the guaranteed tail calls and
+    // musttail calls (i.e. multiversion dispatch, @tailcall) need matching
+    // conventions on both ends
+    if (function.hasAddressTaken() ||
+        function.getCallingConv() != llvm::CallingConv::C ||
+        has_musttail_call(function) || is_musttail_callee(function)) {
+      continue;
+    }
+    function.setCallingConv(llvm::CallingConv::Fast);
+    for (auto* user : function.users()) {
+      if (auto* call = llvm::dyn_cast<llvm::CallBase>(user)) {
+        call->setCallingConv(llvm::CallingConv::Fast);
+      }
+    }
+  }
+
+  --*logger;
+}
+}  // namespace yallc
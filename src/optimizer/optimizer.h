@@ -0,0 +1,34 @@
+#pragma once
+
+#include <llvm/IR/Module.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include <set>
+#include <string>
+
+#include "../compiler/compileroptions.h"
+#include "../import/import.h"
+#include "../logging/logger.h"
+
+namespace yallc {
+
+// Runs the LLVM pipeline for the -O level on the whole module, including the
+// instrumentation or the use of a profile for PGO
+class Optimizer {
+ public:
+  explicit Optimizer(llvm::TargetMachine* target_machine = nullptr)
+      : target_machine(target_machine) {}
+
+  bool optimize(llvm::Module& module);
+
+  // --whole-program, only main and the exported functions stay visible, the
+  // rest becomes internal and uses fastcc where every call is known
+  void internalize(llvm::Module& module,
+                   const std::set<std::string>& exported);
+
+ private:
+  yalll::Import<util::Logger> logger;
+  yalll::Import<CompilerOptions> options;
+  llvm::TargetMachine* target_machine;
+};
+}  // namespace yallc
@@ -9,8 +9,9 @@ void Scope::push(std::string ctx_name) {
   logger->send_log("Scope pushed");
   scope_frames.push_back(ScopeData());
 
-  if (ctx_name != "") {
-    scope_frames.back().ctx_name = (scope_frames.end() - 1)->ctx_name;
+  // unnamed scopes inherit the context of their parent
+  if (ctx_name == "") {
+    scope_frames.back().ctx_name = (scope_frames.end() - 2)->ctx_name;
   } else {
     scope_frames.back().ctx_name = ctx_name;
   }
@@ -35,6 +36,11 @@ void Scope::add_function(const std::string& name, yalll::Function&& func) {
       std::pair<std::string, yalll::Function>(name, func));
 }
 
+void Scope::add_class(const std::string& name, yalll::Class&& klass) {
+  scope_frames.back().class_map.insert(
+      std::pair<std::string, yalll::Class>(name, klass));
+}
+
 yalll::Value* Scope::find_field(const std::string& name) {
   logger->send_log("Searching for variable {}", name);
   if (active_function) {
@@ -48,19 +54,32 @@ yalll::Value* Scope::find_field(const std::string& name) {
     }
   }
 
-  for (auto i = scope_frames.size() - 1; i >= 0; --i) {
+  for (auto i = scope_frames.size(); i-- > 0;) {
     if (scope_frames.at(i).field_map.contains(name)) {
       logger->send_log("Variable {} found", name);
       return &scope_frames.at(i).field_map.at(name);
     }
   }
-  logger->send_error("{} does not exist in current scope");
+  logger->send_error("{} does not exist in current scope", name);
   return nullptr;
 }
 
+bool Scope::has_field(const std::string& name) {
+  if (active_function) {
+    for (auto& param : active_function->get_parameters()) {
+      if (param.name == name) return true;
+    }
+  }
+
+  for (auto& frame : scope_frames) {
+    if (frame.field_map.contains(name)) return true;
+  }
+  return false;
+}
+
 yalll::Function* Scope::find_function(const std::string& name) {
   logger->send_log("Searching for function {}", name);
-  for (auto i = scope_frames.size() - 1; i >= 0; --i) {
+  for (auto i = scope_frames.size(); i-- > 0;) {
     if (scope_frames.at(i).func_map.contains(name)) {
       logger->send_log("Function {} found", name);
       return &scope_frames.at(i).func_map.at(name);
@@ -71,6 +90,27 @@ yalll::Function* Scope::find_function(const std::string& name) {
   return nullptr;
 }
 
+yalll::Function* Scope::lookup_function(const std::string& name) {
+  for (auto i = scope_frames.size(); i-- > 0;) {
+    if (scope_frames.at(i).func_map.contains(name))
+      return &scope_frames.at(i).func_map.at(name);
+  }
+  return nullptr;
+}
+
+yalll::Class* Scope::find_class(const std::string& name) {
+  logger->send_log("Searching for class {}", name);
+  for (auto i = scope_frames.size(); i-- > 0;) {
+    if (scope_frames.at(i).class_map.contains(name)) {
+      logger->send_log("Class {} found", name);
+      return &scope_frames.at(i).class_map.at(name);
+    }
+  }
+
+  logger->send_error("Class with name {} does not exist", name);
+  return nullptr;
+}
+
 void Scope::set_active_function(const std::string& name) {
   active_function = find_function(name);
   if (active_function)
@@ -84,6 +124,19 @@ void Scope::no_active_function() {
   logger->send_log("Deactivated active function");
 }
 
+void Scope::set_active_class(const std::string& name) {
+  active_class = find_class(name);
+  if (active_class)
+    logger->send_log("Set active class to {}", name);
+  else
+    logger->send_internal_error("Failed to set active class");
+}
+
+void Scope::no_active_class() {
+  active_class = nullptr;
+  logger->send_log("Deactivated active class");
+}
+
 std::string& Scope::get_scope_ctx_name() {
   return scope_frames.back().ctx_name;
 }
@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 
+#include "../class/class.h"
 #include "../value/value.h"
 #include "../function/function.h"
 
@@ -14,6 +15,7 @@ namespace scoping {
 struct ScopeData {
   std::unordered_map<std::string, yalll::Value> field_map;
   std::unordered_map<std::string, yalll::Function> func_map;
+  std::unordered_map<std::string, yalll::Class> class_map;
   std::string ctx_name;
 };
 
@@ -25,20 +27,31 @@ class Scope {
 
   void add_field(const std::string& name, yalll::Value&& value);
   void add_function(const std::string& name, yalll::Function&& func);
+  void add_class(const std::string& name, yalll::Class&& klass);
 
   yalll::Value* find_field(const std::string& name);
+  // like find_field, but a missing field isn't an error
+  bool has_field(const std::string& name);
   yalll::Function* find_function(const std::string& name);
+  // like find_function, but a missing function isn't an error
+  yalll::Function* lookup_function(const std::string& name);
+  yalll::Class* find_class(const std::string& name);
 
   void set_active_function(const std::string& name);
   void no_active_function();
   bool has_active_function() { return active_function != nullptr; }
   yalll::Function* get_active_function() { return active_function; }
 
+  void set_active_class(const std::string& name);
+  void no_active_class();
+  yalll::Class* get_active_class() { return active_class; }
+
   std::string& get_scope_ctx_name();
 
  private:
   std::vector<ScopeData> scope_frames {ScopeData()};
   yalll::Import<util::Logger> logger;
   yalll::Function* active_function = nullptr;
+  yalll::Class* active_class = nullptr;
 };
 }  // namespace scoping
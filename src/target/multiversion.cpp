@@ -0,0 +1,194 @@
+#include "multiversion.h"
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Constants.h>
+#include <llvm/IR/DerivedTypes.h>
+#include <llvm/IR/GlobalIFunc.h>
+#include <llvm/IR/GlobalVariable.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Transforms/Utils/ModuleUtils.h>
+#include <llvm/Transforms/Utils/ValueMapper.h>
+
+#include <algorithm>
+#include <map>
+
+namespace yallc {
+
+// bits of __cpu_model.__cpu_features[0], filled by __cpu_indicator_init of
+// libgcc and compiler-rt
+static const std::map<std::string, unsigned> feature_bits = {
+    {"popcnt", 2},    {"sse4.2", 8},    {"avx", 9},       {"avx2", 10},
+    {"fma", 14},      {"avx512f", 15},  {"bmi", 16},      {"bmi2", 17},
+    {"avx512vl", 20}, {"avx512bw", 21}, {"avx512dq", 22}, {"avx512cd", 23}};
+
+bool Multiversioning::is_known_feature(const std::string& feature) {
+  return feature_bits.contains(feature);
+}
+
+void Multiversioning::add(llvm::Function* function,
+                          std::vector<std::string> features, size_t line) {
+  logger->send_log("Multiversioning {} for {} features",
+                   function->getName().str(), features.size());
+  requests.push_back(MultiversionRequest{function, features, line});
+}
+
+void Multiversioning::generate(llvm::Module& module, Target& target) {
+  for (auto& request : requests) {
+    // the features can only be detected on x86
+    if (!target.is_x86()) {
+      logger->send_warning(
+          "@multiversion of {} in line {} needs an x86 target, only the "
+          "default version is compiled",
+          request.function->getName().str(), request.line);
+      continue;
+    }
+    generate_versions(module, target, request);
+  }
+}
+
+// every use outside of the default version goes through the dispatch, like
+// the other versions its recursive calls stay inside of it
+inline void dispatch_uses(llvm::Function* function, llvm::Constant* dispatch) {
+  function->replaceUsesWithIf(dispatch, [function](llvm::Use& use) {
+    auto* instruction = llvm::dyn_cast<llvm::Instruction>(use.getUser());
+    return !instruction || instruction->getFunction() != function;
+  });
+}
+
+void Multiversioning::generate_versions(llvm::Module& module, Target& target,
+                                        MultiversionRequest& request) {
+  auto* function = request.function;
+  auto name = function->getName().str();
+  auto linkage = function->getLinkage();
+  // the body that was already generated becomes the default version
+  function->setName(name + ".default");
+
+  std::vector<Version> versions;
+  for (auto& feature : request.features) {
+    auto suffix = feature;
+    std::replace(suffix.begin(), suffix.end(), '.', '_');
+    auto* version = llvm::Function::Create(function->getFunctionType(),
+                                           llvm::Function::InternalLinkage,
+                                           name + "." + suffix, module);
+
+    llvm::ValueToValueMapTy value_map;
+    auto version_arg = version->arg_begin();
+    for (auto& arg : function->args()) {
+      version_arg->setName(arg.getName());
+      value_map[&arg] = &*version_arg++;
+    }
+    // recursive calls stay inside their version
+    value_map[function] = version;
+    llvm::SmallVector<llvm::ReturnInst*, 8> returns;
+    llvm::CloneFunctionInto(version, function, value_map,
+                            llvm::CloneFunctionChangeType::LocalChangesOnly,
+                            returns);
+    version->setLinkage(llvm::Function::InternalLinkage);
+
+    auto base_features =
+        function->getFnAttribute("target-features").getValueAsString().str();
+    version->addFnAttr("target-features", base_features.empty()
+                                              ? "+" + feature
+                                              : base_features + ",+" + feature);
+    versions.push_back(Version{feature_bits.at(feature), version});
+  }
+
+  // every other use goes through the dispatch from now on, only the resolver
+  // picks one of the versions
+  auto* resolver = llvm::Function::Create(
+      llvm::FunctionType::get(llvm::PointerType::get(module.getContext(), 0),
+                              false),
+      llvm::Function::InternalLinkage, name + ".resolver", module);
+  if (target.supports_ifunc()) {
+    auto* ifunc = llvm::GlobalIFunc::create(function->getFunctionType(), 0,
+                                            linkage, name, resolver, &module);
+    dispatch_uses(function, ifunc);
+  } else {
+    auto* thunk = llvm::Function::Create(function->getFunctionType(), linkage,
+                                         name, module);
+    thunk->copyAttributesFrom(function);
+    dispatch_uses(function, thunk);
+    dispatch_through_pointer(module, thunk, resolver);
+  }
+  function->setLinkage(llvm::Function::InternalLinkage);
+  generate_resolver(resolver, function, versions);
+}
+
+void Multiversioning::generate_resolver(llvm::Function* resolver,
+                                        llvm::Function* fallback,
+                                        std::vector<Version>& versions) {
+  auto& module = *resolver->getParent();
+  auto& context = module.getContext();
+  auto* i32 = llvm::Type::getInt32Ty(context);
+  llvm::IRBuilder<> resolver_builder(
+      llvm::BasicBlock::Create(context, "entry", resolver));
+
+  // resolvers of ifuncs run before any constructor, so the cpu model has to
+  // be initialized by hand
+  auto cpu_init = module.getOrInsertFunction(
+      "__cpu_indicator_init", llvm::FunctionType::get(
+                                  llvm::Type::getVoidTy(context), false));
+  resolver_builder.CreateCall(cpu_init);
+
+  // struct { i32 vendor, type, subtype; [1 x i32] features }
+  auto* model_type = llvm::StructType::get(
+      context, {i32, i32, i32, llvm::ArrayType::get(i32, 1)});
+  auto* model = module.getOrInsertGlobal("__cpu_model", model_type);
+  auto* features_ptr = resolver_builder.CreateInBoundsGEP(
+      model_type, model,
+      {resolver_builder.getInt32(0), resolver_builder.getInt32(3),
+       resolver_builder.getInt32(0)});
+  auto* features = resolver_builder.CreateLoad(i32, features_ptr, "features");
+
+  llvm::Value* selected = fallback;
+  for (auto& [bit, version] : versions) {
+    auto* mask = resolver_builder.getInt32(1u << bit);
+    auto* supported = resolver_builder.CreateICmpEQ(
+        resolver_builder.CreateAnd(features, mask), mask);
+    selected = resolver_builder.CreateSelect(supported, version, selected);
+  }
+  resolver_builder.CreateRet(selected);
+}
+
+void Multiversioning::dispatch_through_pointer(llvm::Module& module,
+                                               llvm::Function* thunk,
+                                               llvm::Function* resolver) {
+  auto& context = module.getContext();
+  auto* ptr = llvm::PointerType::get(context, 0);
+  auto name = thunk->getName().str();
+  auto* pointer = new llvm::GlobalVariable(
+      module, ptr, false, llvm::GlobalValue::InternalLinkage,
+      llvm::ConstantPointerNull::get(ptr), name + ".ptr");
+
+  // the constructor resolves the version once
+  auto* init = llvm::Function::Create(
+      llvm::FunctionType::get(llvm::Type::getVoidTy(context), false),
+      llvm::Function::InternalLinkage, name + ".init", module);
+  llvm::IRBuilder<> dispatch_builder(
+      llvm::BasicBlock::Create(context, "entry", init));
+  dispatch_builder.CreateStore(dispatch_builder.CreateCall(resolver), pointer);
+  dispatch_builder.CreateRetVoid();
+  // priorities up to 100 are reserved for the implementation, resolving
+  // first keeps the versions usable from every other constructor
+  llvm::appendToGlobalCtors(module, init, 101);
+
+  // the function itself only jumps to the resolved version
+  dispatch_builder.SetInsertPoint(
+      llvm::BasicBlock::Create(context, "entry", thunk));
+  std::vector<llvm::Value*> args;
+  for (auto& arg : thunk->args()) {
+    args.push_back(&arg);
+  }
+  auto* call = dispatch_builder.CreateCall(
+      thunk->getFunctionType(),
+      dispatch_builder.CreateLoad(ptr, pointer, "version"), args);
+  call->setCallingConv(thunk->getCallingConv());
+  call->setTailCallKind(llvm::CallInst::TCK_MustTail);
+  if (thunk->getReturnType()->isVoidTy())
+    dispatch_builder.CreateRetVoid();
+  else
+    dispatch_builder.CreateRet(call);
+}
+}  // namespace yallc
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Module.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../import/import.h"
+#include "../logging/logger.h"
+#include "target.h"
+
+namespace yallc {
+
+// @multiversion(avx2, avx512f) on a function definition
+struct MultiversionRequest {
+  llvm::Function* function;
+  std::vector<std::string> features;
+  size_t line;
+};
+
+// A multiversioned function is compiled once per feature and once more for
+// the default target. The best version the cpu supports is picked once at
+// load time, either by an ifunc (ELF) or by a constructor storing it in a
+// pointer the function jumps through. Later features are preferred, so they
+// go from the least to the most specific.
+class Multiversioning {
+ public:
+  static bool is_known_feature(const std::string& feature);
+
+  void add(llvm::Function* function, std::vector<std::string> features,
+           size_t line);
+  // has to run after Target::annotate, the versions extend its features
+  void generate(llvm::Module& module, Target& target);
+
+ private:
+  using Version = std::pair<unsigned, llvm::Function*>;
+
+  void generate_versions(llvm::Module& module, Target& target,
+                         MultiversionRequest& request);
+  void generate_resolver(llvm::Function* resolver, llvm::Function* fallback,
+                         std::vector<Version>& versions);
+  void dispatch_through_pointer(llvm::Module& module, llvm::Function* thunk,
+                                llvm::Function* resolver);
+
+  yalll::Import<util::Logger> logger;
+  std::vector<MultiversionRequest> requests;
+};
+}  // namespace yallc
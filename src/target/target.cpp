@@ -0,0 +1,116 @@
+#include "target.h"
+
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Config/llvm-config.h>
+#include <llvm/MC/TargetRegistry.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Target/TargetOptions.h>
+// the host and triple headers moved to TargetParser in LLVM 17 and 16
+#if LLVM_VERSION_MAJOR >= 17
+#include <llvm/TargetParser/Host.h>
+#else
+#include <llvm/Support/Host.h>
+#endif
+#if LLVM_VERSION_MAJOR >= 16
+#include <llvm/TargetParser/Triple.h>
+#else
+#include <llvm/ADT/Triple.h>
+#endif
+
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace yallc {
+
+bool Target::initialize() {
+  // several compilations can start at the same time
+  static std::once_flag initialized;
+  std::call_once(initialized, []() { llvm::InitializeNativeTarget(); });
+
+  auto triple = llvm::sys::getDefaultTargetTriple();
+  std::string error;
+  auto* target = llvm::TargetRegistry::lookupTarget(triple, error);
+  if (!target) {
+    logger->send_warning("No backend for {}, {}", triple, error);
+    return false;
+  }
+
+  cpu = options->target_cpu == "native" ? llvm::sys::getHostCPUName().str()
+                                        : options->target_cpu;
+  if (cpu.empty()) cpu = "generic";
+  features = resolve_features(options->target_features);
+
+  // position independent, ifuncs and the resolved pointers of multiversioned
+  // functions end up in shared objects as well
+  machine.reset(target->createTargetMachine(triple, cpu, features,
+                                            llvm::TargetOptions(),
+                                            llvm::Reloc::PIC_));
+  if (!machine) {
+    logger->send_warning("Can't create a target machine for {} ({})", triple,
+                         cpu);
+    return false;
+  }
+  logger->send_log("Compiling for {} cpu {} features {}", triple, cpu,
+                   features.empty() ? "default" : features);
+  return true;
+}
+
+void Target::configure(llvm::Module& module) {
+  if (!machine) return;
+  module.setTargetTriple(machine->getTargetTriple().str());
+  module.setDataLayout(machine->createDataLayout());
+}
+
+void Target::annotate(llvm::Module& module) {
+  // the defaults of the triple don't need to be spelled out
+  if (!machine || (options->target_cpu.empty() && features.empty())) return;
+
+  for (auto& function : module) {
+    if (function.isDeclaration()) continue;
+    function.addFnAttr("target-cpu", cpu);
+    if (!features.empty()) function.addFnAttr("target-features", features);
+  }
+}
+
+bool Target::is_x86() const {
+  return machine && machine->getTargetTriple().isX86();
+}
+
+bool Target::supports_ifunc() const {
+  return machine && machine->getTargetTriple().isOSBinFormatELF();
+}
+
+std::string Target::resolve_features(const std::string& requested) {
+  std::vector<std::string> resolved;
+  std::stringstream stream(requested);
+  std::string feature;
+  while (std::getline(stream, feature, ',')) {
+    if (feature.empty()) continue;
+    if (feature == "native") {
+      llvm::StringMap<bool> host_features;
+      if (!llvm::sys::getHostCPUFeatures(host_features)) {
+        logger->send_warning("Can't detect the features of the host cpu");
+        continue;
+      }
+      for (auto& host_feature : host_features) {
+        resolved.push_back((host_feature.second ? "+" : "-") +
+                           host_feature.first().str());
+      }
+      continue;
+    }
+    // avx2 is short for +avx2
+    if (feature.front() != '+' && feature.front() != '-') {
+      feature = "+" + feature;
+    }
+    resolved.push_back(feature);
+  }
+
+  std::string joined;
+  for (auto& entry : resolved) {
+    if (!joined.empty()) joined.push_back(',');
+    joined.append(entry);
+  }
+  return joined;
+}
+}  // namespace yallc
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <llvm/IR/Function.h>
+#include <llvm/IR/Module.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include <memory>
+#include <string>
+
+#include "../compiler/compileroptions.h"
+#include "../import/import.h"
+#include "../logging/logger.h"
+
+namespace yallc {
+
+// The machine the program is compiled for. That is the host, unless
+// --target-cpu or --target-features ask for something else, native resolves
+// to the cpu (features) of the host.
+class Target {
+ public:
+  // false if there is no LLVM backend for the host
+  bool initialize();
+
+  // triple and data layout have to be set before any code is generated, type
+  // sizes depend on them
+  void configure(llvm::Module& module);
+  // target-cpu and target-features of every function with a body
+  void annotate(llvm::Module& module);
+
+  llvm::TargetMachine* get_machine() { return machine.get(); }
+  const std::string& get_cpu() const { return cpu; }
+  const std::string& get_features() const { return features; }
+  bool is_x86() const;
+  bool supports_ifunc() const;
+
+ private:
+  // expands native and joins everything into +feature,-feature,...
+  std::string resolve_features(const std::string& requested);
+
+  yalll::Import<util::Logger> logger;
+  yalll::Import<CompilerOptions> options;
+
+  std::unique_ptr<llvm::TargetMachine> machine;
+  std::string cpu;
+  std::string features;
+};
+}  // namespace yallc
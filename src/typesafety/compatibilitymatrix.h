@@ -21,7 +21,9 @@ static std::map<size_t, std::map<size_t, bool>> compatiblity_matrix = {
       {YALLLParser::TBD_T, false},
       {INTAUTO_T_ID, true},
       {DECAUTO_T_ID, false},
-      {YALLLParser::VOID_T, false}}},
+      {YALLLParser::VOID_T, false},
+      {OBJECT_T_ID, false},
+      {YALLLParser::ERROR_KW, false}}},
     {YALLLParser::I16_T,
      {{YALLLParser::I8_T, true},
       {YALLLParser::I16_T, true},
@@ -37,7 +39,9 @@ static std::map<size_t, std::map<size_t, bool>> compatiblity_matrix = {
       {YALLLParser::TBD_T, false},
       {INTAUTO_T_ID, true},
       {DECAUTO_T_ID, false},
-      {YALLLParser::VOID_T, false}}},
+      {YALLLParser::VOID_T, false},
+      {OBJECT_T_ID, false},
+      {YALLLParser::ERROR_KW, false}}},
     {YALLLParser::I32_T,
      {{YALLLParser::I8_T, true},
       {YALLLParser::I16_T, true},
@@ -53,7 +57,9 @@ static std::map<size_t, std::map<size_t, bool>> compatiblity_matrix = {
       {YALLLParser::TBD_T, false},
       {INTAUTO_T_ID, true},
       {DECAUTO_T_ID, false},
-      {YALLLParser::VOID_T, false}}},
+      {YALLLParser::VOID_T, false},
+      {OBJECT_T_ID, false},
+      {YALLLParser::ERROR_KW, false}}},
     {YALLLParser::I64_T,
      {{YALLLParser::I8_T, true},
       {YALLLParser::I16_T, true},
@@ -69,7 +75,9 @@ static std::map<size_t, std::map<size_t, bool>> compatiblity_matrix = {
       {YALLLParser::TBD_T, false},
       {INTAUTO_T_ID, true},
       {DECAUTO_T_ID, false},
-      {YALLLParser::VOID_T, false}}},
+      {YALLLParser::VOID_T, false},
+      {OBJECT_T_ID, false},
+      {YALLLParser::ERROR_KW, false}}},
     {YALLLParser::U8_T,
      {{YALLLParser::I8_T, false},
       {YALLLParser::I16_T, false},
@@ -85,7 +93,9 @@ static std::map<size_t, std::map<size_t, bool>> compatiblity_matrix = {
       {YALLLParser::TBD_T, false},
       {INTAUTO_T_ID, true},
       {DECAUTO_T_ID, false},
-      {YALLLParser::VOID_T, false}}},
+      {YALLLParser::VOID_T, false},
+      {OBJECT_T_ID, false},
+      {YALLLParser::ERROR_KW, false}}},
     {YALLLParser::U16_T,
      {{YALLLParser::I8_T, false},
       {YALLLParser::I16_T, false},
@@ -101,7 +111,9 @@ static std::map<size_t, std::map<size_t, bool>> compatiblity_matrix = {
       {YALLLParser::TBD_T, false},
       {INTAUTO_T_ID, true},
       {DECAUTO_T_ID, false},
-      {YALLLParser::VOID_T, false}}},
+      {YALLLParser::VOID_T, false},
+      {OBJECT_T_ID, false},
+      {YALLLParser::ERROR_KW, false}}},
     {YALLLParser::U32_T,
      {{YALLLParser::I8_T, false},
       {YALLLParser::I16_T, false},
@@ -117,7 +129,9 @@ static std::map<size_t, std::map<size_t, bool>> compatiblity_matrix = {
       {YALLLParser::TBD_T, false},
       {INTAUTO_T_ID, true},
       {DECAUTO_T_ID, false},
-      {YALLLParser::VOID_T, false}}},
+      {YALLLParser::VOID_T, false},
+      {OBJECT_T_ID, false},
+      {YALLLParser::ERROR_KW, false}}},
     {YALLLParser::U64_T,
      {{YALLLParser::I8_T, false},
       {YALLLParser::I16_T, false},
@@ -133,7 +147,9 @@ static std::map<size_t, std::map<size_t, bool>> compatiblity_matrix = {
       {YALLLParser::TBD_T, false},
       {INTAUTO_T_ID, true},
       {DECAUTO_T_ID, false},
-      {YALLLParser::VOID_T, false}}},
+      {YALLLParser::VOID_T, false},
+      {OBJECT_T_ID, false},
+      {YALLLParser::ERROR_KW, false}}},
     {INTAUTO_T_ID,
      {{YALLLParser::I8_T, true},
       {YALLLParser::I16_T, true},
@@ -149,7 +165,9 @@ static std::map<size_t, std::map<size_t, bool>> compatiblity_matrix = {
       {YALLLParser::TBD_T, false},
       {INTAUTO_T_ID, true},
       {DECAUTO_T_ID, false},
-      {YALLLParser::VOID_T, false}}},
+      {YALLLParser::VOID_T, false},
+      {OBJECT_T_ID, false},
+      {YALLLParser::ERROR_KW, false}}},
     {YALLLParser::D32_T,
      {{YALLLParser::I8_T, false},
       {YALLLParser::I16_T, false},
@@ -165,7 +183,9 @@ static std::map<size_t, std::map<size_t, bool>> compatiblity_matrix = {
       {YALLLParser::TBD_T, false},
       {INTAUTO_T_ID, false},
       {DECAUTO_T_ID, true},
-      {YALLLParser::VOID_T, false}}},
+      {YALLLParser::VOID_T, false},
+      {OBJECT_T_ID, false},
+      {YALLLParser::ERROR_KW, false}}},
     {YALLLParser::D64_T,
      {{YALLLParser::I8_T, false},
       {YALLLParser::I16_T, false},
@@ -181,7 +201,9 @@ static std::map<size_t, std::map<size_t, bool>> compatiblity_matrix = {
       {YALLLParser::TBD_T, false},
       {INTAUTO_T_ID, false},
       {DECAUTO_T_ID, true},
-      {YALLLParser::VOID_T, false}}},
+      {YALLLParser::VOID_T, false},
+      {OBJECT_T_ID, false},
+      {YALLLParser::ERROR_KW, false}}},
     {DECAUTO_T_ID,
      {{YALLLParser::I8_T, false},
       {YALLLParser::I16_T, false},
@@ -197,7 +219,9 @@ static std::map<size_t, std::map<size_t, bool>> compatiblity_matrix = {
       {YALLLParser::TBD_T, false},
       {INTAUTO_T_ID, false},
       {DECAUTO_T_ID, true},
-      {YALLLParser::VOID_T, false}}},
+      {YALLLParser::VOID_T, false},
+      {OBJECT_T_ID, false},
+      {YALLLParser::ERROR_KW, false}}},
     {YALLLParser::BOOL_T,
      {{YALLLParser::I8_T, false},
       {YALLLParser::I16_T, false},
@@ -213,7 +237,9 @@ static std::map<size_t, std::map<size_t, bool>> compatiblity_matrix = {
       {YALLLParser::TBD_T, false},
       {INTAUTO_T_ID, false},
       {DECAUTO_T_ID, false},
-      {YALLLParser::VOID_T, false}}},
+      {YALLLParser::VOID_T, false},
+      {OBJECT_T_ID, false},
+      {YALLLParser::ERROR_KW, false}}},
     {YALLLParser::TBD_T,
      {{YALLLParser::I8_T, true},
       {YALLLParser::I16_T, true},
@@ -229,7 +255,9 @@ static std::map<size_t, std::map<size_t, bool>> compatiblity_matrix = {
       {YALLLParser::TBD_T, true},
       {INTAUTO_T_ID, true},
       {DECAUTO_T_ID, true},
-      {YALLLParser::VOID_T, true}}},
+      {YALLLParser::VOID_T, true},
+      {OBJECT_T_ID, true},
+      {YALLLParser::ERROR_KW, true}}},
     {YALLLParser::VOID_T,
      {{YALLLParser::I8_T, false},
       {YALLLParser::I16_T, false},
@@ -245,5 +273,43 @@ static std::map<size_t, std::map<size_t, bool>> compatiblity_matrix = {
       {YALLLParser::TBD_T, false},
       {INTAUTO_T_ID, false},
       {DECAUTO_T_ID, false},
-      {YALLLParser::VOID_T, true}}}};
+      {YALLLParser::VOID_T, true},
+      {OBJECT_T_ID, false},
+      {YALLLParser::ERROR_KW, false}}},
+    {OBJECT_T_ID,
+     {{YALLLParser::I8_T, false},
+      {YALLLParser::I16_T, false},
+      {YALLLParser::I32_T, false},
+      {YALLLParser::I64_T, false},
+      {YALLLParser::U8_T, false},
+      {YALLLParser::U16_T, false},
+      {YALLLParser::U32_T, false},
+      {YALLLParser::U64_T, false},
+      {YALLLParser::BOOL_T, false},
+      {YALLLParser::D32_T, false},
+      {YALLLParser::D64_T, false},
+      {YALLLParser::TBD_T, false},
+      {INTAUTO_T_ID, false},
+      {DECAUTO_T_ID, false},
+      {YALLLParser::VOID_T, false},
+      {OBJECT_T_ID, true},
+      {YALLLParser::ERROR_KW, false}}},
+    {YALLLParser::ERROR_KW,
+     {{YALLLParser::I8_T, false},
+      {YALLLParser::I16_T, false},
+      {YALLLParser::I32_T, false},
+      {YALLLParser::I64_T, false},
+      {YALLLParser::U8_T, false},
+      {YALLLParser::U16_T, false},
+      {YALLLParser::U32_T, false},
+      {YALLLParser::U64_T, false},
+      {YALLLParser::BOOL_T, false},
+      {YALLLParser::D32_T, false},
+      {YALLLParser::D64_T, false},
+      {YALLLParser::TBD_T, false},
+      {INTAUTO_T_ID, false},
+      {DECAUTO_T_ID, false},
+      {YALLLParser::VOID_T, false},
+      {OBJECT_T_ID, false},
+      {YALLLParser::ERROR_KW, true}}}};
 }
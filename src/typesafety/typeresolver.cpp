@@ -11,6 +11,12 @@
 #include "typesizes.h"
 
 namespace typesafety {
+
+// the yalll_t of an object doesn't know its class, the attached value does
+inline bool same_class(TypeInformation& type, yalll::Value* value) {
+  return !value || !type.is_object() || type.is_compatible(value->type_info);
+}
+
 bool TypeResolver::try_resolve(std::vector<TypeProposal>& values) {
   yalll::Import<util::Logger> logger;
 
@@ -57,9 +63,17 @@ bool TypeResolver::try_resolve(std::vector<TypeProposal>& values) {
   }
 
   for (auto val : values) {
+    if (values.at(0).attached_value &&
+        !same_class(values.at(0).attached_value->type_info,
+                    val.attached_value)) {
+      incompatible_types(values.at(0).attached_value->type_info,
+                         val.attached_value->type_info,
+                         val.attached_value->get_line());
+      return false;
+    }
     if (TypeInformation::yalll_ts_compatible(biggest_type, val.yalll_type)) {
       if (!fixed_proposal_found &&
-          type_size.at(val.yalll_type) > type_size.at(biggest_type)) {
+          yalll_t_size(val.yalll_type) > yalll_t_size(biggest_type)) {
         biggest_type = val.yalll_type;
       }
     } else {
@@ -95,7 +109,10 @@ bool TypeResolver::try_resolve_to_type(std::vector<TypeProposal>& values,
       logger->send_error("resolving failed");
       return false;
     }
-    if (!hint.is_compatible(val.yalll_type)) {
+    // scalars can become vectors, but not the other way around
+    if (!hint.is_compatible(val.yalll_type) ||
+        (is_vector_yalll_t(val.yalll_type) && !hint.is_vector()) ||
+        !same_class(hint, val.attached_value)) {
       auto tmp = TypeInformation::from_yalll_t(val.yalll_type);
       incompatible_types(tmp, hint, 0);
       logger->send_error("resolving failed");
@@ -4,7 +4,9 @@
 #include <llvm/IR/Type.h>
 #include <llvm/Support/Casting.h>
 
+#include <charconv>
 #include <format>
+#include <string_view>
 
 #include "../import/import.h"
 #include "../logging/logger.h"
@@ -14,6 +16,9 @@
 
 namespace typesafety {
 
+static_assert(YALLLParser::TBD_T <= VECTOR_ELEMENT_MASK,
+              "base types don't fit into the element of a vector type");
+
 TypeInformation& TypeInformation::operator=(const TypeInformation& other) {
   if (this == &other) return *this;
 
@@ -21,6 +26,7 @@ TypeInformation& TypeInformation::operator=(const TypeInformation& other) {
   llvm_t = other.llvm_t;
   errable = other.errable;
   mutable_ = other.mutable_;
+  class_name = other.class_name;
 
   return *this;
 }
@@ -30,13 +36,14 @@ TypeInformation& TypeInformation::operator=(TypeInformation&& other) {
   llvm_t = other.llvm_t;
   errable = other.errable;
   mutable_ = other.mutable_;
+  class_name = other.class_name;
 
   return *this;
 }
 
 bool TypeInformation::operator>(TypeInformation& other) {
-  if (compatiblity_matrix.at(yalll_t).at(other.yalll_t)) {
-    return type_size.at(yalll_t) > type_size.at(other.yalll_t);
+  if (yalll_ts_compatible(yalll_t, other.yalll_t)) {
+    return yalll_t_size(yalll_t) > yalll_t_size(other.yalll_t);
   }
   throw "Don't try to compare incompatible types please.";
 }
@@ -46,8 +53,8 @@ bool TypeInformation::operator<(TypeInformation& other) {
 }
 
 bool TypeInformation::operator>=(TypeInformation& other) {
-  if (compatiblity_matrix.at(yalll_t).at(other.yalll_t)) {
-    return type_size.at(yalll_t) >= type_size.at(other.yalll_t);
+  if (yalll_ts_compatible(yalll_t, other.yalll_t)) {
+    return yalll_t_size(yalll_t) >= yalll_t_size(other.yalll_t);
   }
   throw "Don't try to compare incomaptible types please.";
 }
@@ -57,13 +64,18 @@ bool TypeInformation::operator<=(TypeInformation& other) {
 }
 
 bool TypeInformation::operator==(TypeInformation& other) {
-  if (compatiblity_matrix.at(yalll_t).at(other.yalll_t)) {
-    return type_size.at(yalll_t) == type_size.at(other.yalll_t);
+  if (yalll_ts_compatible(yalll_t, other.yalll_t)) {
+    return yalll_t_size(yalll_t) == yalll_t_size(other.yalll_t);
   }
   throw "Don't try to compare incompatible types please.";
 }
 
 TypeInformation TypeInformation::from_yalll_t(size_t yalll_t) {
+  if (is_vector_yalll_t(yalll_t)) {
+    return VEC_T(from_yalll_t(vector_element_yalll_t(yalll_t)),
+                 vector_lanes(yalll_t));
+  }
+
   switch (yalll_t) {
     case YALLLParser::I8_T:
       return I8_T();
@@ -89,10 +101,14 @@ TypeInformation TypeInformation::from_yalll_t(size_t yalll_t) {
       return BOOL_T();
     case YALLLParser::VOID_T:
       return VOID_T();
+    case YALLLParser::ERROR_KW:
+      return ERROR_T();
     case INTAUTO_T_ID:
       return INTAUTO_T();
     case DECAUTO_T_ID:
       return DECAUTO_T();
+    case OBJECT_T_ID:
+      return OBJECT_T("");
     case YALLLParser::TBD_T:
       return TBD_T();
     default:
@@ -103,9 +119,43 @@ TypeInformation TypeInformation::from_yalll_t(size_t yalll_t) {
   }
 }
 
+TypeInformation TypeInformation::from_vector_t(const std::string& name) {
+  static const std::map<std::string, size_t> elements = {
+      {"i8", YALLLParser::I8_T},   {"i16", YALLLParser::I16_T},
+      {"i32", YALLLParser::I32_T}, {"i64", YALLLParser::I64_T},
+      {"u8", YALLLParser::U8_T},   {"u16", YALLLParser::U16_T},
+      {"u32", YALLLParser::U32_T}, {"u64", YALLLParser::U64_T},
+      {"d32", YALLLParser::D32_T}, {"d64", YALLLParser::D64_T},
+      {"bool", YALLLParser::BOOL_T}};
+
+  yalll::Import<util::Logger> logger;
+  auto separator = name.find('x');
+  auto element = name.substr(0, separator);
+  auto lane_digits = std::string_view(name).substr(separator + 1);
+  size_t lanes = 0;
+  auto [ptr, ec] = std::from_chars(
+      lane_digits.data(), lane_digits.data() + lane_digits.size(), lanes);
+  if (ec == std::errc::result_out_of_range) {
+    logger->send_error("Invalid vector type {}, vector lane count too large",
+                       name);
+    return TBD_T();
+  }
+  // a power of two lanes maps onto whole registers
+  if (!elements.contains(element) || lanes < 2 || lanes > MAX_VECTOR_LANES ||
+      (lanes & (lanes - 1)) != 0) {
+    logger->send_error(
+        "Invalid vector type {}, lanes have to be a power of two from 2 to {}",
+        name, MAX_VECTOR_LANES);
+    return TBD_T();
+  }
+  return VEC_T(from_yalll_t(elements.at(element)), lanes);
+}
+
 TypeInformation TypeInformation::from_context_node(
     YALLLParser::TypeContext* node) {
-  auto type = from_yalll_t(node->ty->getStart()->getType());
+  auto type = node->ty->class_t ? OBJECT_T(node->ty->class_t->getText())
+              : node->ty->vec_t ? from_vector_t(node->ty->vec_t->getText())
+                                : from_yalll_t(node->ty->getStart()->getType());
   if (node->errable) type = type.make_errable();
   if (node->mutable_) type = type.make_mutable();
   return type;
@@ -122,6 +172,7 @@ TypeInformation& TypeInformation::make_errable() {
 }
 
 bool TypeInformation::is_signed() const {
+  if (is_vector()) return get_element_type().is_signed();
   if (yalll_t_signed_map.contains(yalll_t)) {
     return yalll_t_signed_map.at(yalll_t);
   }
@@ -133,14 +184,26 @@ bool TypeInformation::is_errable() const { return errable; }
 bool TypeInformation::is_mutable() const { return mutable_; }
 
 bool TypeInformation::is_compatible(TypeInformation& other) const {
-  return compatiblity_matrix.at(yalll_t).at(other.yalll_t);
+  // an object without a class name is one of any class
+  if (is_object() && other.is_object() && !class_name.empty() &&
+      !other.class_name.empty())
+    return class_name == other.class_name;
+  return yalll_ts_compatible(yalll_t, other.yalll_t);
 }
 
 bool TypeInformation::is_compatible(size_t yalll_t) const {
-  return compatiblity_matrix.at(this->yalll_t).at(yalll_t);
+  return yalll_ts_compatible(this->yalll_t, yalll_t);
 }
 
 bool TypeInformation::yalll_ts_compatible(size_t lhs, size_t rhs) {
+  // vectors only mix with vectors of the same shape and with scalars fitting
+  // their elements, the scalar is splatted into every lane
+  if (is_vector_yalll_t(lhs) && is_vector_yalll_t(rhs)) return lhs == rhs;
+  if (is_vector_yalll_t(lhs))
+    return yalll_ts_compatible(vector_element_yalll_t(lhs), rhs);
+  if (is_vector_yalll_t(rhs))
+    return yalll_ts_compatible(lhs, vector_element_yalll_t(rhs));
+
   if (compatiblity_matrix.contains(lhs) &&
       compatiblity_matrix.at(lhs).contains(rhs))
     return compatiblity_matrix.at(lhs).at(rhs);
@@ -148,9 +211,15 @@ bool TypeInformation::yalll_ts_compatible(size_t lhs, size_t rhs) {
 }
 
 bool TypeInformation::is_float_type() const {
+  if (is_vector()) return get_element_type().is_float_type();
   return yalll_t == YALLLParser::D32_T || yalll_t == YALLLParser::D64_T;
 }
 
+TypeInformation TypeInformation::get_element_type() const {
+  if (!is_vector()) return *this;
+  return from_yalll_t(vector_element_yalll_t(yalll_t));
+}
+
 std::string TypeInformation::to_string() const {
   std::string base_t;
   switch (yalll_t) {
@@ -187,6 +256,9 @@ std::string TypeInformation::to_string() const {
     case YALLLParser::BOOL_T:
       base_t = "bool";
       break;
+    case YALLLParser::ERROR_KW:
+      base_t = "error";
+      break;
     case INTAUTO_T_ID:
       base_t = "integer";
       break;
@@ -196,9 +268,15 @@ std::string TypeInformation::to_string() const {
     case YALLLParser::TBD_T:
       base_t = "tbd";
       break;
+    case OBJECT_T_ID:
+      base_t = class_name.empty() ? "object" : class_name;
+      break;
 
     default:
-      base_t = std::format("Unknown {}", yalll_t);
+      base_t = is_vector() ? std::format("{}x{}",
+                                         get_element_type().to_string(),
+                                         get_lanes())
+                           : std::format("Unknown {}", yalll_t);
       break;
   }
 
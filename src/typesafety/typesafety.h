@@ -7,6 +7,7 @@
 
 #include <cstddef>
 #include <map>
+#include <string>
 
 #include "../import/import.h"
 #include "YALLLParser.h"
@@ -15,6 +16,27 @@ namespace typesafety {
 
 constexpr size_t INTAUTO_T_ID = 42069;
 constexpr size_t DECAUTO_T_ID = 133769;
+constexpr size_t OBJECT_T_ID = 1337;
+
+// vector types carry their element type and lane count inside of the yalll_t:
+// VECTOR_T_FLAG | lanes << VECTOR_LANES_SHIFT | element
+constexpr size_t VECTOR_T_FLAG = 1 << 24;
+constexpr size_t VECTOR_LANES_SHIFT = 8;
+constexpr size_t VECTOR_ELEMENT_MASK = (1 << VECTOR_LANES_SHIFT) - 1;
+constexpr size_t MAX_VECTOR_LANES = 64;
+
+inline bool is_vector_yalll_t(size_t yalll_t) {
+  return yalll_t & VECTOR_T_FLAG;
+}
+inline size_t vector_yalll_t(size_t element, size_t lanes) {
+  return VECTOR_T_FLAG | lanes << VECTOR_LANES_SHIFT | element;
+}
+inline size_t vector_element_yalll_t(size_t yalll_t) {
+  return yalll_t & VECTOR_ELEMENT_MASK;
+}
+inline size_t vector_lanes(size_t yalll_t) {
+  return (yalll_t & ~VECTOR_T_FLAG) >> VECTOR_LANES_SHIFT;
+}
 
 class TypeInformation {
  public:
@@ -23,13 +45,15 @@ class TypeInformation {
       : llvm_t(other.llvm_t),
         yalll_t(other.yalll_t),
         mutable_(other.mutable_),
-        errable(other.errable) {}
+        errable(other.errable),
+        class_name(other.class_name) {}
   TypeInformation& operator=(const TypeInformation& other);
   TypeInformation(TypeInformation&& other)
       : llvm_t(other.llvm_t),
         yalll_t(other.yalll_t),
         mutable_(other.mutable_),
-        errable(other.errable) {}
+        errable(other.errable),
+        class_name(other.class_name) {}
   TypeInformation& operator=(TypeInformation&& other);
   bool operator>(TypeInformation& other);
   bool operator<(TypeInformation& other);
@@ -100,8 +124,30 @@ class TypeInformation {
     yalll::Import<llvm::LLVMContext> ctx;
     return TypeInformation(llvm::Type::getFloatTy(*ctx), DECAUTO_T_ID);
   }
+  static TypeInformation ERROR_T() {
+    yalll::Import<llvm::LLVMContext> ctx;
+    return TypeInformation(llvm::Type::getInt16Ty(*ctx),
+                           YALLLParser::ERROR_KW);
+  }
+  // objects are always handled through a pointer into the object memory or
+  // the stack frame they were created in
+  static TypeInformation OBJECT_T(const std::string& class_name) {
+    yalll::Import<llvm::LLVMContext> ctx;
+    auto type = TypeInformation(llvm::PointerType::get(*ctx, 0), OBJECT_T_ID);
+    type.class_name = class_name;
+    return type;
+  }
+
+  // i32x4, the elements are integers, decimals or bools (masks)
+  static TypeInformation VEC_T(const TypeInformation& element, size_t lanes) {
+    return TypeInformation(
+        llvm::FixedVectorType::get(element.get_llvm_type(), lanes),
+        vector_yalll_t(element.get_yalll_type(), lanes));
+  }
 
   static TypeInformation from_yalll_t(size_t yalll_t);
+  // parses the name of a vector type like d32x8
+  static TypeInformation from_vector_t(const std::string& name);
 
   static TypeInformation from_context_node(YALLLParser::TypeContext* node);
 
@@ -115,6 +161,13 @@ class TypeInformation {
   bool is_compatible(size_t yalll_t) const;
   static bool yalll_ts_compatible(size_t lhs, size_t rhs);
   bool is_float_type() const;
+  bool is_object() const { return yalll_t == OBJECT_T_ID; }
+  bool is_error() const { return yalll_t == YALLLParser::ERROR_KW; }
+  bool is_vector() const { return is_vector_yalll_t(yalll_t); }
+  size_t get_lanes() const { return vector_lanes(yalll_t); }
+  TypeInformation get_element_type() const;
+
+  const std::string& get_class_name() const { return class_name; }
 
   llvm::Type* get_llvm_type() const { return llvm_t; };
   size_t get_yalll_type() const { return yalll_t; }
@@ -128,6 +181,8 @@ class TypeInformation {
   bool mutable_ = false;
   bool errable = false;
 
+  std::string class_name;
+
   std::map<size_t, bool> yalll_t_signed_map = {
       {YALLLParser::I8_T, true},    {YALLLParser::I16_T, true},
       {YALLLParser::I32_T, true},   {YALLLParser::I64_T, true},
@@ -136,7 +191,8 @@ class TypeInformation {
       {YALLLParser::BOOL_T, false}, {YALLLParser::D32_T, true},
       {YALLLParser::D64_T, true},   {YALLLParser::VOID_T, false},
       {YALLLParser::USYS_T, false}, {YALLLParser::ISYS_T, true},
-      {INTAUTO_T_ID, true},         {DECAUTO_T_ID, true}};
+      {INTAUTO_T_ID, true},         {DECAUTO_T_ID, true},
+      {YALLLParser::ERROR_KW, false}};
 };
 
 }  // namespace typesafety
@@ -12,5 +12,16 @@ static std::map<size_t, size_t> type_size = {
     {YALLLParser::BOOL_T, 1}, {YALLLParser::D32_T, 32},
     {YALLLParser::D64_T, 64}, {YALLLParser::TBD_T, 64},
     {INTAUTO_T_ID, 32},       {DECAUTO_T_ID, 32},
+    {OBJECT_T_ID, 64},        {YALLLParser::ERROR_KW, 16},
+    {YALLLParser::VOID_T, 0},
 };
+
+// size in bits, vectors take the space of all of their lanes
+inline size_t yalll_t_size(size_t yalll_t) {
+  if (is_vector_yalll_t(yalll_t)) {
+    return vector_lanes(yalll_t) *
+           type_size.at(vector_element_yalll_t(yalll_t));
+  }
+  return type_size.at(yalll_t);
+}
 }
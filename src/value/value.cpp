@@ -14,6 +14,9 @@ Value::Value(const Value& other) {
   type_info = other.type_info;
   named = other.named;
   value_string = other.value_string;
+  line = other.line;
+  err_id = other.err_id;
+  ssa_variable = other.ssa_variable;
 }
 
 Value& Value::operator=(const Value& other) {
@@ -24,6 +27,9 @@ Value& Value::operator=(const Value& other) {
   type_info = other.type_info;
   named = other.named;
   value_string = other.value_string;
+  line = other.line;
+  err_id = other.err_id;
+  ssa_variable = other.ssa_variable;
 
   return *this;
 }
@@ -34,6 +40,9 @@ Value::Value(Value&& other) {
   type_info = other.type_info;
   named = other.named;
   value_string = other.value_string;
+  line = other.line;
+  err_id = other.err_id;
+  ssa_variable = other.ssa_variable;
 }
 
 Value& Value::operator=(Value&& other) {
@@ -42,6 +51,9 @@ Value& Value::operator=(Value&& other) {
   type_info = other.type_info;
   named = other.named;
   value_string = other.value_string;
+  line = other.line;
+  err_id = other.err_id;
+  ssa_variable = other.ssa_variable;
   return *this;
 }
 
@@ -64,6 +76,15 @@ llvm::Value* Value::get_llvm_val() {
     logger->send_log("Converting: {} to {}", value_string,
                      type_info.to_string());
 
+    // literals used as vectors end up in every lane
+    if (type_info.is_vector()) {
+      auto element = Value(type_info.get_element_type(), value_string, line);
+      llvm_val = llvm::ConstantVector::getSplat(
+          llvm::ElementCount::getFixed(type_info.get_lanes()),
+          llvm::cast<llvm::Constant>(element.get_llvm_val()));
+      return llvm_val;
+    }
+
     yalll::Import<llvm::IRBuilder<>> builder;
     switch (type_info.get_yalll_type()) {
       case YALLLParser::I8_T:
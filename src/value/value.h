@@ -62,6 +62,12 @@ class Value {
   llvm::Value* llvm_cast(typesafety::TypeInformation& type_info);
 
   llvm::Value* llvm_val = nullptr;
+  // error id returned alongside the value by an errable call, 0 meaning no
+  // error
+  llvm::Value* err_id = nullptr;
+  // mutable and declared variables are read through the SSABuilder, their
+  // llvm_val stays empty. 0 for everything else
+  size_t ssa_variable = 0;
 
  private:
   yalll::Import<util::Logger> logger;